@@ -0,0 +1,445 @@
+// Benchmark harness for the evaluator, the solver and the full-frame pipeline.
+// Runs a fixed corpus of equations and prints one JSON document on stdout so
+// results can be compared across versions. Links the static library so it can
+// reach the internal stages directly.
+#include "graphcalc_internal.h"
+
+#include <time.h>
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define BENCH_VERSION 1
+#define BENCH_EVAL_POINTS 1024
+#define BENCH_SOLVE_SAMPLES 64
+#define BENCH_DEFAULT_MIN_SECONDS 0.25
+
+// Which build produced this binary (set by the Makefile, e.g. "pgo+lto")
+#ifndef BENCH_BUILD
+#define BENCH_BUILD "default"
+#endif
+
+typedef struct {
+    const char* name;
+    const char* equation;
+    double x_min;  // x range for the evaluator and solver cases
+    double x_max;
+} BenchCase;
+
+static const BenchCase bench_cases[] = {
+    {"explicit_cubic", "y = x^3 - 2*x", -3, 3},
+    {"implicit_conic", "x^2/4 + y^2 = 1", -2, 2},
+    {"trig_heavy", "y = sin(3*x)*cos(x) + sin(x)^2 - cos(2*x)", -8, 8},
+    {"log_domain_edge", "y = ln(x)", 1e-6, 1e-2},
+    {"tan_poles", "y = tan(x)", -8, 8},
+};
+
+static const double bench_zooms[] = {0.25, 1.0, 4.0, 64.0};
+
+#define NUM_BENCH_CASES ((int)(sizeof(bench_cases) / sizeof(bench_cases[0])))
+#define NUM_BENCH_ZOOMS ((int)(sizeof(bench_zooms) / sizeof(bench_zooms[0])))
+
+// Deep-zoom comparison: the same point of the curve viewed at a zoom double precision
+// still resolves and at one that needs the double-double path
+#define BENCH_DOUBLE_ZOOM 1e6
+#define BENCH_DEEP_ZOOM 1e16
+
+// Hardware counters read around every measurement. Each worker thread opens its own
+// set (pid 0 counts the calling thread only), so multi-threaded frames are summed over
+// the whole team. Any counter the kernel refuses is reported as null.
+#define NUM_PERF_COUNTERS 4
+#define MAX_PERF_THREADS 256
+
+static const char* perf_counter_names[NUM_PERF_COUNTERS] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses"
+};
+
+typedef struct {
+    int fds[MAX_PERF_THREADS][NUM_PERF_COUNTERS];
+    int num_threads;
+    int available;
+    char reason[64];
+} PerfCounters;
+
+static PerfCounters perf;
+
+#ifdef __linux__
+static int open_perf_counter(int counter) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (counter) {
+        case 0: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case 1: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case 2: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        default:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | 
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+    }
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+// Open counters on every worker thread; on failure the harness runs without them
+static void perf_open(void) {
+    perf.num_threads = 1;
+#ifdef _OPENMP
+    perf.num_threads = omp_get_max_threads();
+#endif
+    if (perf.num_threads > MAX_PERF_THREADS) perf.num_threads = MAX_PERF_THREADS;
+
+#ifdef __linux__
+    int first_errno = 0;
+    #pragma omp parallel num_threads(perf.num_threads)
+    {
+        int t = 0;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+#endif
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+            perf.fds[t][c] = open_perf_counter(c);
+            if (perf.fds[t][c] < 0) {
+                #pragma omp critical
+                if (!first_errno) first_errno = errno;
+            }
+        }
+    }
+    for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+        if (perf.fds[0][c] >= 0) perf.available = 1;
+    }
+    if (!perf.available) snprintf(perf.reason, sizeof(perf.reason), "%s", strerror(first_errno));
+#else
+    snprintf(perf.reason, sizeof(perf.reason), "perf_event_open needs Linux");
+#endif
+}
+
+static void perf_begin(void) {
+#ifdef __linux__
+    if (!perf.available) return;
+    for (int t = 0; t < perf.num_threads; t++) {
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+            if (perf.fds[t][c] < 0) continue;
+            ioctl(perf.fds[t][c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(perf.fds[t][c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+// Stop the counters and print them per operation as the JSON member named key
+static void perf_end(const char* key, long ops) {
+    printf("\"%s\": ", key);
+    if (!perf.available) {
+        printf("null");
+        return;
+    }
+#ifdef __linux__
+    double totals[NUM_PERF_COUNTERS] = {0};
+    int valid[NUM_PERF_COUNTERS] = {0};
+    for (int t = 0; t < perf.num_threads; t++) {
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+            uint64_t values[3];  // value, time enabled, time running
+            if (perf.fds[t][c] < 0) continue;
+            ioctl(perf.fds[t][c], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(perf.fds[t][c], values, sizeof(values)) != sizeof(values)) continue;
+            // Scale up when the kernel multiplexed the counter
+            double scale = values[2] ? (double)values[1] / values[2] : 0;
+            totals[c] += values[0] * scale;
+            valid[c] = 1;
+        }
+    }
+
+    printf("{");
+    for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+        printf("%s\"%s_per_op\": ", c ? ", " : "", perf_counter_names[c]);
+        if (valid[c]) printf("%.2f", totals[c] / ops);
+        else printf("null");
+    }
+    if (valid[0] && valid[1] && totals[0] > 0) printf(", \"ipc\": %.3f", totals[1] / totals[0]);
+    printf("}");
+#else
+    (void)key;
+    (void)ops;
+#endif
+}
+
+// Keeps results observable so the compiler can't drop the timed work
+static volatile double bench_sink;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void print_json_string(const char* s) {
+    putchar('"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') putchar('\\');
+        putchar(*s);
+    }
+    putchar('"');
+}
+
+// Nanoseconds per evaluate_expression call over a fixed set of points
+static void bench_evaluate(const Equation* eq, const BenchCase* bc, double min_seconds) {
+    double xs[BENCH_EVAL_POINTS], ys[BENCH_EVAL_POINTS];
+    double y_min, y_max;
+    get_seed_range(eq, &y_min, &y_max);
+    for (int i = 0; i < BENCH_EVAL_POINTS; i++) {
+        xs[i] = bc->x_min + (bc->x_max - bc->x_min) * i / (BENCH_EVAL_POINTS - 1);
+        ys[i] = y_min + (y_max - y_min) * ((i * 7) % BENCH_EVAL_POINTS) / (BENCH_EVAL_POINTS - 1);
+    }
+
+    long calls = 0;
+    double sum = 0;
+    perf_begin();
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < BENCH_EVAL_POINTS; i++) {
+            sum += evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, xs[i], ys[i]);
+            sum += evaluate_expression((Token*)eq->right_tokens, eq->right_num_tokens, xs[i], ys[i]);
+        }
+        calls += 2 * BENCH_EVAL_POINTS;
+        elapsed = now_seconds() - start;
+    } while (elapsed < min_seconds);
+
+    bench_sink = sum;
+    printf("\"eval_ns_per_call\": %.2f, ", elapsed * 1e9 / calls);
+    perf_end("eval_counters", calls);
+}
+
+// Nanoseconds per residual (both sides) through the compiled batch evaluator, same points
+static void bench_batch_evaluate(const Equation* eq, const BenchCase* bc, double min_seconds) {
+    double xs[BENCH_EVAL_POINTS], ys[BENCH_EVAL_POINTS], out[BENCH_EVAL_POINTS];
+    double y_min, y_max;
+    get_seed_range(eq, &y_min, &y_max);
+    for (int i = 0; i < BENCH_EVAL_POINTS; i++) {
+        xs[i] = bc->x_min + (bc->x_max - bc->x_min) * i / (BENCH_EVAL_POINTS - 1);
+        ys[i] = y_min + (y_max - y_min) * ((i * 7) % BENCH_EVAL_POINTS) / (BENCH_EVAL_POINTS - 1);
+    }
+    if (eq->residual.length < 0) {
+        printf("\"batch_eval_ns_per_point\": null, ");
+        return;
+    }
+
+    long points = 0;
+    double sum = 0;
+    perf_begin();
+    double start = now_seconds(), elapsed;
+    do {
+        program_eval_batch(&eq->residual, xs, ys, out, BENCH_EVAL_POINTS);
+        sum += out[points % BENCH_EVAL_POINTS];
+        points += BENCH_EVAL_POINTS;
+        elapsed = now_seconds() - start;
+    } while (elapsed < min_seconds);
+
+    bench_sink = sum;
+    printf("\"batch_eval_ns_per_point\": %.2f, ", elapsed * 1e9 / points);
+    perf_end("batch_eval_counters", points);
+}
+
+// Solve from every seed at evenly spaced x values, as one column of a frame would
+static void bench_solve(const Equation* eq, const BenchCase* bc, double min_seconds) {
+    double y_min, y_max;
+    get_seed_range(eq, &y_min, &y_max);
+
+    long solves = 0, iterations = 0, failures = 0;
+    double sum = 0;
+    perf_begin();
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < BENCH_SOLVE_SAMPLES; i++) {
+            double x = bc->x_min + (bc->x_max - bc->x_min) * i / (BENCH_SOLVE_SAMPLES - 1);
+            for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+                int iter;
+                double y0 = y_min + (y_max - y_min) * k / (NUM_INITIAL_GUESSES - 1);
+                double y = solve_equation_counted(eq, x, y0, &iter);
+                iterations += iter;
+                if (isnan(y)) failures++;
+                else sum += y;
+            }
+        }
+        solves += BENCH_SOLVE_SAMPLES * NUM_INITIAL_GUESSES;
+        elapsed = now_seconds() - start;
+    } while (elapsed < min_seconds);
+
+    bench_sink = sum;
+    printf("\"solve\": {\"solves\": %ld, \"ns_per_solve\": %.1f, \"mean_iterations\": %.2f, "
+           "\"failure_rate\": %.4f, ", solves, elapsed * 1e9 / solves, 
+           (double)iterations / solves, (double)failures / solves);
+    perf_end("counters", solves);
+    printf("}");
+}
+
+// Frames per second of render_frame (no terminal output) at each zoom level
+static void bench_frames(const Equation* eq, double min_seconds) {
+    Frame frame;
+    printf("\"frames\": [");
+    for (int z = 0; z < NUM_BENCH_ZOOMS; z++) {
+        PlotSettings settings = {bench_zooms[z], 0.0, 0.0, 0.0, 0.0};
+        int frames = 0;
+        perf_begin();
+        double start = now_seconds(), elapsed;
+        do {
+            render_frame(NULL, &frame, &eq, 1, settings, NULL, 0);
+            frames++;
+            elapsed = now_seconds() - start;
+        } while (elapsed < min_seconds);
+
+        printf("%s{\"zoom\": %g, \"frames\": %d, \"seconds\": %.4f, \"fps\": %.2f, ", 
+               z ? ", " : "", bench_zooms[z], frames, elapsed, frames / elapsed);
+        perf_end("counters", frames);
+        printf("}");
+    }
+    printf("]");
+}
+
+static double frames_per_second(Context* ctx, const Equation* eq, PlotSettings settings, 
+                                double min_seconds) {
+    Frame frame;
+    int frames = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        render_frame(ctx, &frame, &eq, 1, settings, NULL, 0);
+        frames++;
+        elapsed = now_seconds() - start;
+    } while (elapsed < min_seconds);
+    return frames / elapsed;
+}
+
+// Cost of the double-double path relative to plain doubles, centred on a point of the curve
+static void bench_deep_zoom(const Equation* eq, const BenchCase* bc, double min_seconds) {
+    double roots[NUM_INITIAL_GUESSES], distinct[NUM_INITIAL_GUESSES];
+    double y_min, y_max;
+    double x = bc->x_min + (bc->x_max - bc->x_min) * 0.37;
+    get_seed_range(eq, &y_min, &y_max);
+    sample_roots(NULL, eq, x, y_min, y_max, roots);
+
+    PlotSettings deep = {BENCH_DEEP_ZOOM, x, 0.0, 0.0, 0.0};
+    if (collect_distinct_roots(roots, NUM_INITIAL_GUESSES, ROOT_TOLERANCE, distinct) == 0) {
+        printf("\"deep_zoom\": null");
+        return;
+    }
+
+    // The solver's roots are good to about 1e-10; polish one in double-double so the
+    // view is centred on the curve to well under a row even at the deep zoom
+    DoubleDouble y = dd_from(distinct[0]);
+    for (int iter = 0; iter < 8; iter++) {
+        DoubleDouble f = program_eval_dd(&eq->residual, dd_from(x), y);
+        DoubleDouble f_h = program_eval_dd(&eq->residual, dd_from(x), dd_add_d(y, 1e-9));
+        y = dd_add_d(y, -f.hi / (dd_sub(f_h, f).hi / 1e-9));
+    }
+    deep.y_offset = y.hi;
+    deep.y_offset_lo = y.lo;
+    PlotSettings shallow = deep;
+    shallow.zoom = BENCH_DOUBLE_ZOOM;
+    if (!view_needs_double_double(deep) || view_needs_double_double(shallow)) {
+        printf("\"deep_zoom\": null");
+        return;
+    }
+
+    double double_fps = frames_per_second(NULL, eq, shallow, min_seconds);
+    double deep_fps = frames_per_second(NULL, eq, deep, min_seconds);
+    printf("\"deep_zoom\": {\"x\": %.17g, \"y\": %.17g, \"double_zoom\": %g, \"double_fps\": %.2f, "
+           "\"deep_zoom\": %g, \"double_double_fps\": %.2f, \"cost_ratio\": %.2f}", 
+           deep.x_offset, deep.y_offset, shallow.zoom, double_fps, deep.zoom, deep_fps, 
+           double_fps / deep_fps);
+}
+
+// Default single-precision frames against forced double at zoom 1, plus how many cells differ
+static void bench_float_path(const Equation* eq, double min_seconds) {
+    PlotSettings settings = {1.0, 0.0, 0.0, 0.0, 0.0};
+    Context ctx = {0};
+    Frame frame;
+
+    ctx.refine_depth = ADAPTIVE_MAX_DEPTH;  // Fully refined, like every other case
+    ctx.precision = GC_PRECISION_FAST;
+    double float_fps = frames_per_second(&ctx, eq, settings, min_seconds);
+    ctx.precision = GC_PRECISION_DOUBLE;
+    double double_fps = frames_per_second(&ctx, eq, settings, min_seconds);
+    ctx.precision = GC_PRECISION_VALIDATE;
+    render_frame(&ctx, &frame, &eq, 1, settings, NULL, 0);
+
+    printf("\"float_path\": {\"float_fps\": %.2f, \"double_fps\": %.2f, \"speedup\": %.2f, "
+           "\"mismatched_cells\": %d}", float_fps, double_fps, float_fps / double_fps, 
+           ctx.float_mismatches);
+}
+
+int main(int argc, char** argv) {
+    double min_seconds = BENCH_DEFAULT_MIN_SECONDS;
+    const char* only = NULL;
+    int use_counters = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--case") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--no-counters") == 0) {
+            use_counters = 0;
+        } else {
+            fprintf(stderr, "usage: %s [--min-time SECONDS] [--case NAME] [--no-counters]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    if (use_counters) perf_open();
+    else snprintf(perf.reason, sizeof(perf.reason), "disabled");
+
+    printf("{\"benchmark\": \"graphcalc\", \"version\": %d, \"build\": \"%s\", \"isa\": \"%s\", "
+           "\"threads\": %d, \"min_seconds\": %g, ", BENCH_VERSION, BENCH_BUILD, program_isa(), 
+           threads, min_seconds);
+    printf("\"perf_counters\": {\"available\": %s", perf.available ? "true" : "false");
+    if (!perf.available) {
+        printf(", \"reason\": ");
+        print_json_string(perf.reason);
+    }
+    printf("}, \"cases\": [\n");
+
+    int first = 1;
+    for (int c = 0; c < NUM_BENCH_CASES; c++) {
+        const BenchCase* bc = &bench_cases[c];
+        if (only && strcmp(only, bc->name) != 0) continue;
+
+        Equation eq;
+        parse_equation(bc->equation, NULL, &eq);
+
+        printf("%s  {\"name\": ", first ? "" : ",\n");
+        print_json_string(bc->name);
+        printf(", \"equation\": ");
+        print_json_string(bc->equation);
+        printf(", ");
+        bench_evaluate(&eq, bc, min_seconds);
+        printf(", ");
+        bench_batch_evaluate(&eq, bc, min_seconds);
+        printf(", ");
+        bench_solve(&eq, bc, min_seconds);
+        printf(", ");
+        bench_frames(&eq, min_seconds);
+        printf(", ");
+        bench_deep_zoom(&eq, bc, min_seconds);
+        printf(", ");
+        bench_float_path(&eq, min_seconds);
+        printf("}");
+        fflush(stdout);
+        first = 0;
+    }
+    printf("\n]}\n");
+    return 0;
+}
@@ -0,0 +1,183 @@
+// libgraphcalc: tokenizer, evaluator, solver and renderers behind a small C API.
+//
+// Compiled equations are immutable and may be shared between threads. Frames and
+// contexts hold mutable state and belong to one thread at a time; give each thread
+// its own. The only global state is the evaluator variant, chosen once on first use.
+#ifndef GRAPHCALC_H
+#define GRAPHCALC_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GRAPHCALC_VERSION_MAJOR 1
+#define GRAPHCALC_VERSION_MINOR 0
+#define GRAPHCALC_VERSION_PATCH 0
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GC_API __attribute__((visibility("default")))
+#else
+#define GC_API
+#endif
+
+#define GC_GRID_WIDTH 80
+#define GC_GRID_HEIGHT 20
+#define GC_MAX_EQUATION_LENGTH 256
+#define GC_MAX_EQUATIONS 20
+
+// Opaque handles
+typedef struct gc_equation gc_equation;
+typedef struct gc_frame gc_frame;
+typedef struct gc_context gc_context;
+
+// Viewport: 5 * zoom grid cells per unit, centred on (x_offset, y_offset). The _lo
+// fields extend the offsets to double-double precision for deep zoom; leave them 0
+// or move the view with gc_view_pan, which keeps them up to date.
+typedef struct {
+    double zoom;
+    double x_offset;
+    double y_offset;
+    double x_offset_lo;
+    double y_offset_lo;
+} gc_view;
+
+// Background heat map of the first equation's residual left - right behind a printed
+// frame: off, the xterm 256-colour cube, or 24-bit true colour (gc_context_set_heat_map)
+typedef enum {
+    GC_HEAT_OFF,
+    GC_HEAT_256,
+    GC_HEAT_TRUECOLOR
+} gc_heat_map;
+
+// Display options for printing frames
+typedef struct {
+    int use_color;
+    int show_stats;
+} gc_plot_options;
+
+// Labelled point drawn on top of the curves and listed below the plot
+typedef struct {
+    double x;
+    double y;
+    char glyph;
+    char label[32];
+} gc_marker;
+
+GC_API const char* gc_version(void);
+
+// Instruction set variant of the batch evaluator chosen for this CPU: "avx512f",
+// "avx2", "sse4.2" or "default". Set GRAPHCALC_ISA to one of these to force a
+// variant; requests the CPU cannot run are ignored.
+GC_API const char* gc_isa(void);
+
+// Contexts carry per-thread settings and instrumentation. Every function taking a
+// context also accepts NULL. Statistics are only collected when the library was
+// built with GRAPHCALC_STATS; gc_stats_enabled reports whether it was.
+GC_API gc_context* gc_context_create(void);
+GC_API void gc_context_free(gc_context* ctx);
+GC_API int gc_stats_enabled(void);
+GC_API void gc_context_reset_stats(gc_context* ctx);
+GC_API int gc_context_print_stats(const gc_context* ctx, FILE* out);
+
+// How gc_frame_render solves. FAST uses single precision wherever the view allows it
+// and re-checks ill-conditioned roots in double; DOUBLE never uses floats; VALIDATE
+// renders both ways, keeps the double frame and records how many cells differed.
+// A NULL context renders FAST.
+typedef enum {
+    GC_PRECISION_FAST,
+    GC_PRECISION_DOUBLE,
+    GC_PRECISION_VALIDATE
+} gc_precision;
+GC_API void gc_context_set_precision(gc_context* ctx, gc_precision precision);
+// Overlays gc_frame_render adds to equations that are explicit in y, such as
+// y = f(x): the derivative f', the running integral of f, which starts at 0 on the
+// left edge of the view and again after each pole or gap, and the zeros, extrema and
+// inflections of f inside the view (see gc_frame_features). Off by default.
+#define GC_OVERLAY_DERIVATIVE 1
+#define GC_OVERLAY_INTEGRAL 2
+#define GC_OVERLAY_FEATURES 4
+GC_API void gc_context_set_overlays(gc_context* ctx, unsigned overlays);
+// Heat map gc_frame_render computes into the frame and gc_frame_print paints behind
+// the grid. Off by default.
+GC_API void gc_context_set_heat_map(gc_context* ctx, gc_heat_map heat_map);
+// Cells that differed between the float and double frames of the last VALIDATE
+// render, or -1 if that render did not compare (not validating, or float unusable)
+GC_API int gc_context_float_mismatches(const gc_context* ctx);
+
+// Session symbols kept by the context: "name = value" defines a parameter, or updates
+// it in place, and "name(arg) = expression" a function of one argument. Equations
+// compiled afterwards read parameters through slots, so an update reaches them
+// without recompiling, while user functions are inlined where they are called; such
+// equations must be freed before their context. Returns 1 once stored, 0 when text
+// is not a definition (compile it as an equation) and -1 when it cannot be stored:
+// an undefined name, a body too long once expanded, a full table or no context.
+GC_API int gc_define(gc_context* ctx, const char* text);
+// Set a parameter defined with gc_define; compiled equations see the new value at
+// their next evaluation. Returns -1 if name is not a parameter.
+GC_API int gc_context_set_parameter(gc_context* ctx, const char* name, double value);
+
+// Equations of the form "left = right" in x and y; a missing '=' means "= 0". The
+// inequality, contour, parametric and polar forms are described in the README.
+// Returns NULL if memory runs out.
+GC_API gc_equation* gc_equation_compile(gc_context* ctx, const char* text);
+GC_API void gc_equation_free(gc_equation* eq);
+GC_API const char* gc_equation_text(const gc_equation* eq);
+// First name in the equation that is neither a variable nor a session symbol, or NULL.
+// Such names evaluate to NaN, so the equation draws nothing until it is recompiled
+// after the name is defined.
+GC_API const char* gc_equation_undefined(const gc_equation* eq);
+GC_API double gc_equation_residual(const gc_equation* eq, double x, double y);
+
+// Newton solve for y at fixed x. Returns NAN when it doesn't converge; the
+// iterations used are stored through iterations when it is non-NULL.
+GC_API double gc_solve(gc_context* ctx, const gc_equation* eq, double x, double initial_y, 
+                       int* iterations);
+// Every distinct root at x, sorted ascending; returns how many were stored
+GC_API int gc_find_roots(gc_context* ctx, const gc_equation* eq, double x, 
+                         double* roots, int max_roots);
+// Every intersection of two curves inside the view; returns how many were stored
+GC_API int gc_find_intersections(const gc_equation* a, const gc_equation* b, gc_view view, 
+                                 double* xs, double* ys, int max_points);
+
+// Move the view centre by (dx, dy) without losing the low-order bits of the offsets
+GC_API void gc_view_pan(gc_view* view, double dx, double dy);
+
+// Character frames of GC_GRID_WIDTH x GC_GRID_HEIGHT cells
+GC_API gc_frame* gc_frame_create(void);
+GC_API void gc_frame_free(gc_frame* frame);
+GC_API int gc_frame_render(gc_context* ctx, gc_frame* frame, const gc_equation* const* eqs, 
+                           int num_equations, gc_view view, 
+                           const gc_marker* markers, int num_markers);
+GC_API char gc_frame_cell(const gc_frame* frame, int row, int col);
+// Feature points the last render found with GC_OVERLAY_FEATURES, solved to full double
+// precision and listed by gc_frame_print; returns how many were stored
+GC_API int gc_frame_features(const gc_frame* frame, gc_marker* markers, int max_markers);
+GC_API void gc_frame_print(gc_context* ctx, const gc_frame* frame, FILE* out, 
+                           const gc_equation* const* eqs, int num_equations, gc_view view, 
+                           gc_plot_options options, const gc_marker* markers, int num_markers);
+
+// Sweep a parameter from `from` to `to` over num_frames frames, printing each to out at
+// up to fps frames per second and redrawing in place when options.use_color is set.
+// Nothing is recompiled. Solving a frame overlaps printing the one before, and when
+// solving falls behind, adaptive refinement is reduced instead of frames being
+// skipped. The parameter is restored afterwards. Returns the frame rate achieved, -1
+// if the parameter is undefined, or -2 if the arguments are invalid or rendering fails.
+GC_API double gc_animate(gc_context* ctx, const gc_equation* const* eqs, int num_equations, 
+                         gc_view view, gc_plot_options options, const char* parameter, 
+                         double from, double to, int num_frames, double fps, FILE* out);
+
+// File exports; each returns 0 on success and -1 on failure
+GC_API int gc_export_raster(const gc_equation* const* eqs, int num_equations, gc_view view, 
+                            const char* filename, int width, int height, int channels);
+GC_API int gc_export_svg(const gc_equation* const* eqs, int num_equations, gc_view view, 
+                         const char* filename, int width, int height);
+GC_API int gc_export_points(const gc_equation* const* eqs, int num_equations, gc_view view, 
+                            const char* filename, int num_samples, int binary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+// Parameter animation: the same compiled equations are re-rendered while one session
+// parameter sweeps a range, only its slot changing between frames
+#include "graphcalc_internal.h"
+#include <time.h>
+
+static double animation_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void sleep_until(double deadline) {
+    double wait = deadline - animation_now();
+    if (wait <= 0) return;
+    struct timespec ts = {(time_t)wait, (long)((wait - floor(wait)) * 1e9)};
+    nanosleep(&ts, NULL);
+}
+
+static void emit_frame(Context* ctx, const Frame* frame, FILE* out, const Equation* const* eqs, 
+                       int num_equations, PlotSettings settings, PlotOptions options, 
+                       const char* name, double value, int depth, int index, int num_frames) {
+    if (options.use_color) fputs("\033[H", out);  // Redraw in place
+    print_frame(ctx, frame, out, eqs, num_equations, settings, options, NULL, 0);
+    fprintf(out, "%s = %-12.6g (frame %d of %d, %d refinement level(s))\n", name, value, 
+            index + 1, num_frames, depth);
+    fflush(out);
+}
+
+// Sweep parameter name from `from` to `to` over num_frames frames paced at fps,
+// printing each. Frame n + 1 is solved while frame n is printed; a solve that takes
+// most of a frame period sheds one level of adaptive refinement for the next frame,
+// and a quick one earns a level back, so the animation keeps every frame. Returns
+// the frame rate achieved, -1 if the parameter is not defined, or -2 if the frame
+// count or rate is invalid or rendering fails.
+double animate_parameter(Context* ctx, const Equation* const* eqs, int num_equations, 
+                         PlotSettings settings, PlotOptions options, const char* name, 
+                         double from, double to, int num_frames, double fps, FILE* out) {
+    double* slot = ctx ? parameter_slot(&ctx->symbols, name) : NULL;
+    if (!slot) return -1;
+    Frame* frames = num_frames > 0 && fps > 0 ? malloc(2 * sizeof(Frame)) : NULL;
+    if (!frames) return -2;
+
+    double saved_value = *slot;
+    int saved_depth = ctx->refine_depth;
+    double period = 1.0 / fps, step = num_frames > 1 ? (to - from) / (num_frames - 1) : 0;
+#ifdef _OPENMP
+    // The solve inside the pipeline keeps its own team of threads
+    int saved_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+#endif
+
+    if (options.use_color) fputs("\033[2J", out);
+    double start = animation_now(), deadline = start;
+    int depths[2] = {ctx->refine_depth, 0};  // Refinement each frame was solved with
+    *slot = from;
+    int status = render_frame(ctx, &frames[0], eqs, num_equations, settings, NULL, 0);
+    for (int n = 0; n < num_frames && status == 0; n++) {
+        const Frame* current = &frames[n % 2];
+        Frame* next = &frames[(n + 1) % 2];
+        double value = from + step * n;
+        int has_next = n + 1 < num_frames;
+
+        // Everything printed, heat map included, was computed with the frame, so the
+        // parameter can move on while it is printed
+        double solve_seconds = 0;
+        depths[(n + 1) % 2] = ctx->refine_depth;
+        if (has_next) *slot = from + step * (n + 1);
+        #pragma omp parallel sections num_threads(2) if (has_next)
+        {
+            #pragma omp section
+            emit_frame(ctx, current, out, eqs, num_equations, settings, options, name, value, 
+                       depths[n % 2], n, num_frames);
+            #pragma omp section
+            if (has_next) {
+                double solve_start = animation_now();
+                status = render_frame(ctx, next, eqs, num_equations, settings, NULL, 0);
+                solve_seconds = animation_now() - solve_start;
+            }
+        }
+
+        // Trade refinement for time, never frames
+        if (solve_seconds > ANIMATION_BUSY * period && ctx->refine_depth > 0) {
+            ctx->refine_depth--;
+        } else if (solve_seconds < ANIMATION_IDLE * period && ctx->refine_depth < ADAPTIVE_MAX_DEPTH) {
+            ctx->refine_depth++;
+        }
+
+        // A late frame moves the schedule rather than rushing the ones after it
+        deadline = fmax(deadline + period, animation_now());
+        if (has_next) sleep_until(deadline);
+    }
+    double seconds = animation_now() - start;
+
+#ifdef _OPENMP
+    omp_set_max_active_levels(saved_levels);
+#endif
+    *slot = saved_value;
+    ctx->refine_depth = saved_depth;
+    free(frames);
+    if (status != 0) return -2;
+    return seconds > 0 ? num_frames / seconds : fps;
+}
@@ -0,0 +1,190 @@
+// Public C API: handle management and thin wrappers over the internal functions
+#include "graphcalc_internal.h"
+
+#define GC_STRINGIFY(x) #x
+#define GC_VERSION_STRING(major, minor, patch) \
+    GC_STRINGIFY(major) "." GC_STRINGIFY(minor) "." GC_STRINGIFY(patch)
+
+const char* gc_version(void) {
+    return GC_VERSION_STRING(GRAPHCALC_VERSION_MAJOR, GRAPHCALC_VERSION_MINOR, 
+                             GRAPHCALC_VERSION_PATCH);
+}
+
+const char* gc_isa(void) {
+    return program_isa();
+}
+
+gc_context* gc_context_create(void) {
+    Context* ctx = calloc(1, sizeof(Context));
+    if (ctx) {
+        ctx->float_mismatches = -1;
+        ctx->refine_depth = ADAPTIVE_MAX_DEPTH;
+    }
+    return ctx;
+}
+
+void gc_context_free(gc_context* ctx) {
+    free(ctx);
+}
+
+int gc_stats_enabled(void) {
+#ifdef GRAPHCALC_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void gc_context_reset_stats(gc_context* ctx) {
+    stats_reset(ctx);
+}
+
+int gc_context_print_stats(const gc_context* ctx, FILE* out) {
+    return stats_print(ctx, out);
+}
+
+void gc_context_set_precision(gc_context* ctx, gc_precision precision) {
+    if (ctx) ctx->precision = precision;
+}
+
+void gc_context_set_overlays(gc_context* ctx, unsigned overlays) {
+    if (ctx) ctx->overlays = overlays;
+}
+
+void gc_context_set_heat_map(gc_context* ctx, gc_heat_map heat_map) {
+    if (ctx) ctx->heat_map = heat_map;
+}
+
+int gc_context_float_mismatches(const gc_context* ctx) {
+    return ctx ? ctx->float_mismatches : -1;
+}
+
+int gc_define(gc_context* ctx, const char* text) {
+    return ctx ? define_symbol(&ctx->symbols, text) : -1;
+}
+
+int gc_context_set_parameter(gc_context* ctx, const char* name, double value) {
+    double* slot = ctx ? parameter_slot(&ctx->symbols, name) : NULL;
+    if (!slot) return -1;
+    *slot = value;
+    return 0;
+}
+
+double gc_animate(gc_context* ctx, const gc_equation* const* eqs, int num_equations, 
+                  gc_view view, gc_plot_options options, const char* parameter, 
+                  double from, double to, int num_frames, double fps, FILE* out) {
+    if (num_equations < 0 || num_equations > MAX_EQUATIONS) return -2;
+    return animate_parameter(ctx, eqs, num_equations, view, options, parameter, from, to, 
+                             num_frames, fps, out);
+}
+
+gc_equation* gc_equation_compile(gc_context* ctx, const char* text) {
+    STATS_TIMER_START(parse_start);
+    Equation* eq = malloc(sizeof(Equation));
+    if (eq) parse_equation(text, ctx ? &ctx->symbols : NULL, eq);
+    STATS_TIMER_STOP(ctx, STAGE_PARSE, parse_start);
+    return eq;
+}
+
+void gc_equation_free(gc_equation* eq) {
+    free(eq);
+}
+
+const char* gc_equation_text(const gc_equation* eq) {
+    return eq->text;
+}
+
+const char* gc_equation_undefined(const gc_equation* eq) {
+    return eq->undefined[0] ? eq->undefined : NULL;
+}
+
+double gc_equation_residual(const gc_equation* eq, double x, double y) {
+    return evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, x, y) - 
+           evaluate_expression((Token*)eq->right_tokens, eq->right_num_tokens, x, y);
+}
+
+double gc_solve(gc_context* ctx, const gc_equation* eq, double x, double initial_y, 
+                int* iterations) {
+    int iter;
+    double y = solve_equation_counted(eq, x, initial_y, &iter);
+    stats_record_solve(ctx, iter);
+    if (iterations) *iterations = iter;
+    return y;
+}
+
+int gc_find_roots(gc_context* ctx, const gc_equation* eq, double x, 
+                  double* roots, int max_roots) {
+    double all[NUM_INITIAL_GUESSES], distinct[NUM_INITIAL_GUESSES];
+    double y_min, y_max;
+    get_seed_range(eq, &y_min, &y_max);
+    sample_roots(ctx, eq, x, y_min, y_max, all);
+
+    int count = collect_distinct_roots(all, NUM_INITIAL_GUESSES, ROOT_TOLERANCE, distinct);
+    if (count > max_roots) count = max_roots;
+    memcpy(roots, distinct, count * sizeof(double));
+    return count;
+}
+
+int gc_find_intersections(const gc_equation* a, const gc_equation* b, gc_view view, 
+                          double* xs, double* ys, int max_points) {
+    return find_intersections(a, b, view, xs, ys, max_points);
+}
+
+void gc_view_pan(gc_view* view, double dx, double dy) {
+    DoubleDouble x = dd_add_d((DoubleDouble){view->x_offset, view->x_offset_lo}, dx);
+    DoubleDouble y = dd_add_d((DoubleDouble){view->y_offset, view->y_offset_lo}, dy);
+    view->x_offset = x.hi;
+    view->x_offset_lo = x.lo;
+    view->y_offset = y.hi;
+    view->y_offset_lo = y.lo;
+}
+
+gc_frame* gc_frame_create(void) {
+    return calloc(1, sizeof(Frame));
+}
+
+void gc_frame_free(gc_frame* frame) {
+    free(frame);
+}
+
+int gc_frame_render(gc_context* ctx, gc_frame* frame, const gc_equation* const* eqs, 
+                    int num_equations, gc_view view, 
+                    const gc_marker* markers, int num_markers) {
+    if (num_equations < 0 || num_equations > MAX_EQUATIONS) return -1;
+    return render_frame(ctx, frame, eqs, num_equations, view, markers, num_markers);
+}
+
+char gc_frame_cell(const gc_frame* frame, int row, int col) {
+    if (row < 0 || row >= GRID_HEIGHT || col < 0 || col >= GRID_WIDTH) return '\0';
+    return frame->grid[row][col];
+}
+
+int gc_frame_features(const gc_frame* frame, gc_marker* markers, int max_markers) {
+    int count = frame->num_features < max_markers ? frame->num_features : max_markers;
+    for (int m = 0; m < count; m++) markers[m] = frame->features[m];
+    return count < 0 ? 0 : count;
+}
+
+void gc_frame_print(gc_context* ctx, const gc_frame* frame, FILE* out, 
+                    const gc_equation* const* eqs, int num_equations, gc_view view, 
+                    gc_plot_options options, const gc_marker* markers, int num_markers) {
+    print_frame(ctx, frame, out, eqs, num_equations, view, options, markers, num_markers);
+}
+
+int gc_export_raster(const gc_equation* const* eqs, int num_equations, gc_view view, 
+                     const char* filename, int width, int height, int channels) {
+    if (num_equations < 0 || num_equations > MAX_EQUATIONS) return -1;
+    return export_raster(eqs, num_equations, view, filename, width, height, channels);
+}
+
+int gc_export_svg(const gc_equation* const* eqs, int num_equations, gc_view view, 
+                  const char* filename, int width, int height) {
+    if (num_equations < 0 || num_equations > MAX_EQUATIONS) return -1;
+    return export_svg(eqs, num_equations, view, filename, width, height);
+}
+
+int gc_export_points(const gc_equation* const* eqs, int num_equations, gc_view view, 
+                     const char* filename, int num_samples, int binary) {
+    if (num_equations < 0 || num_equations > MAX_EQUATIONS) return -1;
+    return export_points(eqs, num_equations, view, filename, num_samples, binary);
+}
@@ -0,0 +1,79 @@
+// Discontinuity detection for the curve joiners: two roots are only linked when a
+// branch of the curve provably runs between them at the resolution being drawn
+#include "graphcalc_internal.h"
+
+// Gauss-Newton projection of (x, y) onto F = 0 along the gradient, which is left in
+// grad. Returns 0 once the step falls below a thousandth of a cell, -1 on failure.
+static int project_to_curve(const Equation* eq, double* x, double* y, double cell, Dual* grad) {
+    for (int iter = 0; iter < CONTINUITY_PROJECT_ITER; iter++) {
+        Dual f = residual_dual(eq, *x, *y);
+        double norm2 = f.dx * f.dx + f.dy * f.dy;
+        if (!isfinite(f.value) || !isfinite(norm2) || norm2 == 0) return -1;
+        *grad = f;
+
+        double step_x = f.value * f.dx / norm2;
+        double step_y = f.value * f.dy / norm2;
+        *x -= step_x;
+        *y -= step_y;
+        if (fabs(step_x) + fabs(step_y) < cell * 1e-3) return 0;
+    }
+    return -1;
+}
+
+// Bisect the chord from (x0, y0) to (x1, y1) until every piece spans at most a cell.
+// Each midpoint is projected onto the curve and has to land inside the chord's box:
+// across a pole or a gap between branches the projection diverges or lands elsewhere.
+static int chord_connected(Context* ctx, const Equation* eq, double x0, double y0, 
+                           double x1, double y1, double cell, int depth) {
+    if (fabs(x1 - x0) <= cell && fabs(y1 - y0) <= cell) return 1;
+    if (depth == 0) return 0;
+
+    double mid_x = 0.5 * (x0 + x1), mid_y = 0.5 * (y0 + y1);
+    double x = mid_x, y = mid_y;
+    Dual grad;
+    STATS_ADD(ctx, continuity_projections, 1);
+    if (project_to_curve(eq, &x, &y, cell, &grad) != 0) return 0;
+    if (x < fmin(x0, x1) - cell || x > fmax(x0, x1) + cell || 
+        y < fmin(y0, y1) - cell || y > fmax(y0, y1) + cell) {
+        return 0;
+    }
+
+    // Curve through the chord's midpoint and running along it to within half a cell
+    // at either end: the straight join is already right. Both are needed, since
+    // where branches are dense the midpoint alone can land on a different one.
+    double across = fabs(grad.dx * (x1 - x0) + grad.dy * (y1 - y0)) / 
+                    sqrt(grad.dx * grad.dx + grad.dy * grad.dy);
+    if (fabs(x - mid_x) <= 0.5 * cell && fabs(y - mid_y) <= 0.5 * cell && across <= cell) return 1;
+    return chord_connected(ctx, eq, x0, y0, x, y, cell, depth - 1) && 
+           chord_connected(ctx, eq, x, y, x1, y1, cell, depth - 1);
+}
+
+// Whether roots (x0, y0) and (x1, y1) of eq lie on one continuous branch, judged at
+// cells of the given size in view units. Joins within one cell are always accepted,
+// so only steep or suspicious joins pay for the bisection.
+int roots_connected(Context* ctx, const Equation* eq, double x0, double y0, 
+                    double x1, double y1, double cell) {
+    return chord_connected(ctx, eq, x0, y0, x1, y1, cell, CONTINUITY_MAX_DEPTH);
+}
+
+// Many seeds converge to the same pair of roots; decide each pair once per step. Roots
+// match within a small fraction of a cell, so deep views don't merge distinct pairs.
+int join_cache_connected(JoinCache* cache, Context* ctx, const Equation* eq, double x0, 
+                         double y0, double x1, double y1, double cell) {
+    double tolerance = fmin(ROOT_TOLERANCE, ROOT_CELL_TOLERANCE * cell);
+    for (int i = 0; i < cache->count; i++) {
+        if (cache->x0[i] == x0 && fabs(cache->from[i] - y0) <= tolerance && 
+            fabs(cache->to[i] - y1) <= tolerance) {
+            return cache->connected[i];
+        }
+    }
+
+    int connected = roots_connected(ctx, eq, x0, y0, x1, y1, cell);
+    if (cache->count < NUM_INITIAL_GUESSES) {
+        cache->x0[cache->count] = x0;
+        cache->from[cache->count] = y0;
+        cache->to[cache->count] = y1;
+        cache->connected[cache->count++] = connected;
+    }
+    return connected;
+}
@@ -0,0 +1,149 @@
+// Contour plots: the field is sampled once on a lattice finer than the cells, and every
+// level is extracted from those samples by marching squares
+#include "graphcalc_internal.h"
+
+// Parse "a..b[, n]" into n levels evenly spaced from a to b, CONTOUR_DEFAULT_LEVELS when
+// n is left out. Returns the number of levels, or 0 when the text is not a range.
+int parse_levels(const char* text, double* levels) {
+    char buffer[MAX_EQUATION_LENGTH];
+    strncpy(buffer, text, MAX_EQUATION_LENGTH - 1);
+    buffer[MAX_EQUATION_LENGTH - 1] = '\0';
+
+    char* dots = strstr(buffer, "..");
+    if (!dots) return 0;
+    *dots = '\0';
+    char* comma = strchr(dots + 2, ',');
+    if (comma) *comma = '\0';
+
+    double lo = evaluate_constant(buffer), hi = evaluate_constant(dots + 2);
+    double count = comma ? evaluate_constant(comma + 1) : CONTOUR_DEFAULT_LEVELS;
+    if (!isfinite(lo) || !isfinite(hi) || !(count >= 1)) return 0;
+    int n = count > MAX_CONTOUR_LEVELS ? MAX_CONTOUR_LEVELS : (int)count;
+
+    for (int i = 0; i < n; i++) levels[i] = n == 1 ? lo : lo + (hi - lo) * i / (n - 1);
+    return n;
+}
+
+// Cell grid being drawn into, with the level currently being traced
+typedef struct {
+    signed char* cells;
+    int width;
+    int height;
+    int level;
+} ContourTarget;
+
+static void plot_contour_cell(void* target, int x, int y) {
+    ContourTarget* t = target;
+    if (x >= 0 && x < t->width && y >= 0 && y < t->height && t->cells[y * t->width + x] < 0) {
+        t->cells[y * t->width + x] = (signed char)t->level;
+    }
+}
+
+// Join two lattice points with a line of cells
+static void draw_segment(ContourTarget* target, double u0, double v0, double u1, double v1) {
+    draw_line((int)floor(u0 / CONTOUR_SUBDIV), (int)floor(v0 / CONTOUR_SUBDIV), 
+              (int)floor(u1 / CONTOUR_SUBDIV), (int)floor(v1 / CONTOUR_SUBDIV), 
+              plot_contour_cell, target);
+}
+
+// Fill cells (height rows of width, row 0 at the top) with the index of the first level
+// whose contour passes through each cell, or -1. The top-left cell's box starts at
+// x_min and ends at y_max. The lattice has CONTOUR_SUBDIV samples per cell side and
+// is evaluated a row at a time through the batch evaluator; levels only add the
+// marching squares pass.
+int contour_levels(Context* ctx, const Equation* eq, double x_min, double y_max, double cell, 
+                   int width, int height, signed char* cells) {
+    int cols = width * CONTOUR_SUBDIV + 1, rows = height * CONTOUR_SUBDIV + 1;
+    double step = cell / CONTOUR_SUBDIV;
+    double* field = malloc((size_t)rows * cols * sizeof(double));
+    double* xs = malloc(cols * sizeof(double));
+    if (!field || !xs) {
+        free(field);
+        free(xs);
+        return -1;
+    }
+    for (int c = 0; c < cols; c++) xs[c] = x_min + c * step;
+
+    int failed = 0;
+    #pragma omp parallel for schedule(dynamic, 4) reduction(|:failed)
+    for (int r = 0; r < rows; r++) {
+        double* out = field + (size_t)r * cols;
+        double y = y_max - r * step;
+        if (eq->residual.length < 0) {
+            for (int c = 0; c < cols; c++) {
+                out[c] = evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, xs[c], y);
+            }
+            continue;
+        }
+        double* ys = malloc(cols * sizeof(double));
+        if (!ys) {
+            failed = 1;
+            continue;
+        }
+        for (int c = 0; c < cols; c++) ys[c] = y;
+        program_eval_batch(&eq->residual, xs, ys, out, cols);
+        free(ys);
+    }
+    free(xs);
+    STATS_ADD(ctx, contour_samples, (uint64_t)rows * cols);
+    if (failed) {
+        free(field);
+        return -1;
+    }
+
+    memset(cells, -1, (size_t)width * height);
+    ContourTarget target = {cells, width, height, 0};
+    for (int r = 0; r + 1 < rows; r++) {
+        for (int c = 0; c + 1 < cols; c++) {
+            // Corners clockwise from the top left, and the edges leaving each of them
+            double v[4] = {field[(size_t)r * cols + c], field[(size_t)r * cols + c + 1], 
+                           field[(size_t)(r + 1) * cols + c + 1], field[(size_t)(r + 1) * cols + c]};
+            static const int corner_u[4] = {0, 1, 1, 0}, corner_v[4] = {0, 0, 1, 1};
+            if (!isfinite(v[0]) || !isfinite(v[1]) || !isfinite(v[2]) || !isfinite(v[3])) continue;
+
+            double v_min = fmin(fmin(v[0], v[1]), fmin(v[2], v[3]));
+            double v_max = fmax(fmax(v[0], v[1]), fmax(v[2], v[3]));
+
+            for (int l = 0; l < eq->num_levels; l++) {
+                double level = eq->levels[l];
+                if (level < v_min || level >= v_max) continue;  // Square entirely on one side
+                double u[4], w[4];
+                int crossed[4], num_crossed = 0;
+                for (int k = 0; k < 4; k++) {
+                    int n = (k + 1) % 4;
+                    crossed[k] = (v[k] > level) != (v[n] > level);
+                    if (!crossed[k]) continue;
+                    double t = (level - v[k]) / (v[n] - v[k]);
+                    u[k] = c + corner_u[k] + t * (corner_u[n] - corner_u[k]);
+                    w[k] = r + corner_v[k] + t * (corner_v[n] - corner_v[k]);
+                    num_crossed++;
+                }
+                if (num_crossed == 0) continue;
+
+                target.level = l;
+                if (num_crossed == 2) {
+                    int a = -1, b = -1;
+                    for (int k = 0; k < 4; k++) {
+                        if (!crossed[k]) continue;
+                        if (a < 0) a = k;
+                        else b = k;
+                    }
+                    draw_segment(&target, u[a], w[a], u[b], w[b]);
+                } else {
+                    // Saddle: the centre decides which diagonal the level separates.
+                    // Edge k runs from corner k to corner k + 1.
+                    int centre_above = (v[0] + v[1] + v[2] + v[3]) / 4 > level;
+                    if (centre_above == (v[0] > level)) {
+                        draw_segment(&target, u[0], w[0], u[1], w[1]);
+                        draw_segment(&target, u[2], w[2], u[3], w[3]);
+                    } else {
+                        draw_segment(&target, u[3], w[3], u[0], w[0]);
+                        draw_segment(&target, u[1], w[1], u[2], w[2]);
+                    }
+                }
+            }
+        }
+    }
+    free(field);
+    return 0;
+}
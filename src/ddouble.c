@@ -0,0 +1,207 @@
+// Double-double arithmetic (a value as an unevaluated sum hi + lo, about 106 bits)
+// and the deep-zoom evaluator built on it
+#include "graphcalc_internal.h"
+
+static const DoubleDouble DD_2PI = {6.283185307179586232e+00, 2.449293598294706414e-16};
+static const DoubleDouble DD_PI_2 = {1.570796326794896558e+00, 6.123233995736766036e-17};
+static const DoubleDouble DD_LN2 = {6.931471805599452862e-01, 2.319046813846299558e-17};
+static const DoubleDouble DD_LN10 = {2.302585092994045901e+00, -2.170756223382249351e-16};
+
+// Error-free transformations: a + b and a * b as rounded result plus exact error
+static DoubleDouble two_sum(double a, double b) {
+    double s = a + b;
+    double bb = s - a;
+    return (DoubleDouble){s, (a - (s - bb)) + (b - bb)};
+}
+
+static DoubleDouble quick_two_sum(double a, double b) {
+    double s = a + b;
+    return (DoubleDouble){s, b - (s - a)};
+}
+
+static DoubleDouble two_prod(double a, double b) {
+    double p = a * b;
+    return (DoubleDouble){p, fma(a, b, -p)};
+}
+
+DoubleDouble dd_from(double a) {
+    return (DoubleDouble){a, 0.0};
+}
+
+DoubleDouble dd_add(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble s = two_sum(a.hi, b.hi);
+    DoubleDouble t = two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = quick_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return quick_two_sum(s.hi, s.lo);
+}
+
+DoubleDouble dd_add_d(DoubleDouble a, double b) {
+    DoubleDouble s = two_sum(a.hi, b);
+    s.lo += a.lo;
+    return quick_two_sum(s.hi, s.lo);
+}
+
+DoubleDouble dd_sub(DoubleDouble a, DoubleDouble b) {
+    return dd_add(a, (DoubleDouble){-b.hi, -b.lo});
+}
+
+static DoubleDouble dd_mul(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble p = two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return quick_two_sum(p.hi, p.lo);
+}
+
+static DoubleDouble dd_mul_d(DoubleDouble a, double b) {
+    DoubleDouble p = two_prod(a.hi, b);
+    p.lo += a.lo * b;
+    return quick_two_sum(p.hi, p.lo);
+}
+
+// Long division: three double quotients, each correcting the remainder of the last
+static DoubleDouble dd_div(DoubleDouble a, DoubleDouble b) {
+    double q1 = a.hi / b.hi;
+    DoubleDouble r = dd_sub(a, dd_mul_d(b, q1));
+    double q2 = r.hi / b.hi;
+    r = dd_sub(r, dd_mul_d(b, q2));
+    double q3 = r.hi / b.hi;
+    return dd_add_d(quick_two_sum(q1, q2), q3);
+}
+
+static DoubleDouble dd_div_d(DoubleDouble a, double b) {
+    return dd_div(a, dd_from(b));
+}
+
+static DoubleDouble dd_ldexp(DoubleDouble a, int e) {
+    return (DoubleDouble){ldexp(a.hi, e), ldexp(a.lo, e)};
+}
+
+// exp(a) = 2^m * exp(r)^512 with r = (a - m ln 2) / 512 small enough for a short Taylor series
+static DoubleDouble dd_exp(DoubleDouble a) {
+    if (a.hi <= -709.0) return dd_from(0.0);
+    if (a.hi >= 709.0 || !isfinite(a.hi)) return dd_from(exp(a.hi));
+
+    double m = floor(a.hi / DD_LN2.hi + 0.5);
+    DoubleDouble r = dd_ldexp(dd_sub(a, dd_mul_d(DD_LN2, m)), -9);
+
+    // s = exp(r) - 1, kept without the leading 1 so squaring loses nothing
+    DoubleDouble s = r, term = r;
+    for (int n = 2; n < 20; n++) {
+        term = dd_div_d(dd_mul(term, r), n);
+        s = dd_add(s, term);
+        if (fabs(term.hi) < 1e-36) break;
+    }
+    for (int i = 0; i < 9; i++) s = dd_add(dd_ldexp(s, 1), dd_mul(s, s));
+    return dd_ldexp(dd_add_d(s, 1.0), (int)m);
+}
+
+// One Newton step on exp(x) = a from the double logarithm doubles its precision
+static DoubleDouble dd_log(DoubleDouble a) {
+    if (!(a.hi > 0) || !isfinite(a.hi)) return dd_from(log(a.hi));
+    DoubleDouble x = dd_from(log(a.hi));
+    return dd_add_d(dd_add(x, dd_mul(a, dd_exp((DoubleDouble){-x.hi, -x.lo}))), -1.0);
+}
+
+// sin and cos of |t| <= pi/4 by Taylor series; sign is -1 for sin terms, cos starts at 1
+static DoubleDouble dd_taylor(DoubleDouble t, int is_sin) {
+    DoubleDouble t2 = dd_mul(t, t);
+    DoubleDouble term = is_sin ? t : dd_from(1.0);
+    DoubleDouble sum = term;
+    for (int n = is_sin ? 3 : 2; n < 40; n += 2) {
+        term = dd_div_d(dd_mul(term, t2), -(double)n * (n - 1));
+        sum = dd_add(sum, term);
+        if (fabs(term.hi) < 1e-36) break;
+    }
+    return sum;
+}
+
+// Reduce modulo 2 pi, then to the nearest quadrant, and pick sin or cos of the remainder
+static DoubleDouble dd_sincos(DoubleDouble a, int is_sin) {
+    if (!isfinite(a.hi)) return dd_from(NAN);
+    DoubleDouble r = dd_sub(a, dd_mul_d(DD_2PI, nearbyint(a.hi / DD_2PI.hi)));
+    double j = nearbyint(r.hi / DD_PI_2.hi);
+    DoubleDouble t = dd_sub(r, dd_mul_d(DD_PI_2, j));
+    int quadrant = ((int)j % 4 + 4) % 4 + (is_sin ? 0 : 1);
+
+    DoubleDouble value = dd_taylor(t, quadrant % 2 == 0);
+    if (quadrant % 4 >= 2) value = (DoubleDouble){-value.hi, -value.lo};
+    return value;
+}
+
+// One Newton step on tan(y) = a from the double atan: y + (a cos y - sin y) cos y
+static DoubleDouble dd_atan(DoubleDouble a) {
+    if (!isfinite(a.hi)) return dd_from(atan(a.hi));
+    DoubleDouble y = dd_from(atan(a.hi));
+    DoubleDouble s = dd_sincos(y, 1), c = dd_sincos(y, 0);
+    return dd_add(y, dd_mul(dd_sub(dd_mul(a, c), s), c));
+}
+
+// Integer powers by repeated squaring; everything else through exp and log.
+// Cases double pow handles specially (zero, negative or non-finite bases) defer to it.
+static DoubleDouble dd_pow(DoubleDouble a, DoubleDouble b) {
+    if (a.hi == 0 || !isfinite(a.hi) || !isfinite(b.hi)) return dd_from(pow(a.hi, b.hi));
+
+    if (b.lo == 0 && b.hi == floor(b.hi) && fabs(b.hi) <= 1 << 30) {
+        long n = (long)fabs(b.hi);
+        DoubleDouble result = dd_from(1.0), base = a;
+        while (n > 0) {
+            if (n & 1) result = dd_mul(result, base);
+            base = dd_mul(base, base);
+            n >>= 1;
+        }
+        return b.hi < 0 ? dd_div(dd_from(1.0), result) : result;
+    }
+    if (a.hi < 0) return dd_from(NAN);
+    return dd_exp(dd_mul(b, dd_log(a)));
+}
+
+// Scalar double-double counterpart of program_eval_batch for one point
+DoubleDouble program_eval_dd(const Program* program, DoubleDouble x, DoubleDouble y) {
+    DoubleDouble stack[PROGRAM_MAX_STACK];
+    int top = -1;
+
+    for (int pc = 0; pc < program->length; pc++) {
+        const Instruction* ins = &program->code[pc];
+        switch (ins->op) {
+            case OP_CONST: stack[++top] = dd_from(ins->value); break;
+            case OP_X: stack[++top] = x; break;
+            case OP_Y: stack[++top] = y; break;
+            case OP_PARAM: stack[++top] = dd_from(*ins->slot); break;
+            case OP_SIN: stack[top] = dd_sincos(stack[top], 1); break;
+            case OP_COS: stack[top] = dd_sincos(stack[top], 0); break;
+            case OP_TAN: 
+                stack[top] = dd_div(dd_sincos(stack[top], 1), dd_sincos(stack[top], 0)); 
+                break;
+            case OP_LOG10: stack[top] = dd_div(dd_log(stack[top]), DD_LN10); break;
+            case OP_LN: stack[top] = dd_log(stack[top]); break;
+            case OP_EXP: stack[top] = dd_exp(stack[top]); break;
+            case OP_ATAN: stack[top] = dd_atan(stack[top]); break;
+            default: {
+                DoubleDouble b = stack[top--];
+                DoubleDouble* a = &stack[top];
+                switch (ins->op) {
+                    case OP_ADD: *a = dd_add(*a, b); break;
+                    case OP_SUB: *a = dd_sub(*a, b); break;
+                    case OP_MUL: *a = dd_mul(*a, b); break;
+                    case OP_DIV: *a = b.hi != 0 ? dd_div(*a, b) : dd_from(INFINITY); break;
+                    default: *a = dd_pow(*a, b); break;
+                }
+                break;
+            }
+        }
+    }
+    return stack[0];
+}
+
+// True when the spacing of samples or rows falls below what a double can resolve
+// at the view's offset, with DEEP_ZOOM_MARGIN to spare for a smooth curve, or when
+// rows shrink towards the double solver's absolute step tolerance EPSILON, which
+// happens first near the origin
+int view_needs_double_double(PlotSettings settings) {
+    double sample_width = 1.0 / (5.0 * settings.zoom * COLUMN_SLOTS);
+    double row_height = 1.0 / (5.0 * settings.zoom);
+    return sample_width < fabs(settings.x_offset) * DBL_EPSILON * DEEP_ZOOM_MARGIN || 
+           row_height < fabs(settings.y_offset) * DBL_EPSILON * DEEP_ZOOM_MARGIN || 
+           row_height < EPSILON * DEEP_ZOOM_SOLVER_MARGIN;
+}
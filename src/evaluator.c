@@ -0,0 +1,477 @@
+// Expression evaluators over token streams: plain doubles, dual numbers, intervals
+#include "graphcalc_internal.h"
+
+// Recursive expression evaluator
+double evaluate_expression(Token* tokens, int num_tokens, double x, double y) {
+    // Handle empty expression
+    if (num_tokens == 0) return 0;
+
+    // Single token case
+    if (num_tokens == 1) {
+        Token token = tokens[0];
+        if (token.type == TOKEN_NUMBER) return token.value;
+        if (token.type == TOKEN_PARAMETER) return *token.slot;
+        if (token.type == TOKEN_VARIABLE) {
+            if (strcmp(token.str, "x") == 0) return x;
+            if (strcmp(token.str, "y") == 0) return y;
+        }
+        return 0;
+    }
+
+    // Find the operator with lowest precedence
+    int min_prec_pos = -1;
+    int min_prec = 999;
+    int paren_depth = 0;
+
+    for (int i = num_tokens - 1; i >= 0; i--) {
+        Token token = tokens[i];
+        
+        if (token.type == TOKEN_RPAREN) paren_depth++;
+        else if (token.type == TOKEN_LPAREN) paren_depth--;
+        else if (paren_depth == 0 && token.type == TOKEN_OPERATOR) {
+            int prec = get_precedence(token.str[0]);
+            if (prec <= min_prec) {
+                min_prec = prec;
+                min_prec_pos = i;
+            }
+        }
+    }
+
+    // If no operator found outside parentheses
+    if (min_prec_pos == -1) {
+        // Check for function call
+        if (tokens[0].type == TOKEN_FUNCTION) {
+            double arg = evaluate_expression(tokens + 2, num_tokens - 3, x, y);
+            if (strcmp(tokens[0].str, "sin") == 0) return sin(arg);
+            if (strcmp(tokens[0].str, "cos") == 0) return cos(arg);
+            if (strcmp(tokens[0].str, "tan") == 0) return tan(arg);
+            if (strcmp(tokens[0].str, "log") == 0) return log10(arg);
+            if (strcmp(tokens[0].str, "ln") == 0) return log(arg);
+            if (strcmp(tokens[0].str, "exp") == 0) return exp(arg);
+            if (strcmp(tokens[0].str, "atan") == 0) return atan(arg);
+        }
+        // Remove surrounding parentheses
+        if (tokens[0].type == TOKEN_LPAREN && tokens[num_tokens-1].type == TOKEN_RPAREN) {
+            return evaluate_expression(tokens + 1, num_tokens - 2, x, y);
+        }
+        return 0;
+    }
+
+    // Split and evaluate
+    double left = evaluate_expression(tokens, min_prec_pos, x, y);
+    double right = evaluate_expression(tokens + min_prec_pos + 1, 
+                                     num_tokens - min_prec_pos - 1, x, y);
+
+    // Perform operation
+    switch (tokens[min_prec_pos].str[0]) {
+        case '+': return left + right;
+        case '-': return left - right;
+        case '*': return left * right;
+        case '/': return right != 0 ? left / right : INFINITY;
+        case '^': return pow(left, right);
+        default: return 0;
+    }
+}
+
+// Value of a constant expression such as a range bound; NaN when the text is empty
+double evaluate_constant(const char* text) {
+    Token tokens[MAX_TOKENS];
+    int num_tokens = tokenize_expression(text, tokens);
+    if (num_tokens == 0) return NAN;
+    return evaluate_expression(tokens, num_tokens, 0, 0);
+}
+
+// Position of the operator an evaluator splits on, or -1 (same rule as evaluate_expression)
+static int find_split_operator(const Token* tokens, int num_tokens) {
+    int min_prec_pos = -1;
+    int min_prec = 999;
+    int paren_depth = 0;
+
+    for (int i = num_tokens - 1; i >= 0; i--) {
+        if (tokens[i].type == TOKEN_RPAREN) paren_depth++;
+        else if (tokens[i].type == TOKEN_LPAREN) paren_depth--;
+        else if (paren_depth == 0 && tokens[i].type == TOKEN_OPERATOR) {
+            int prec = get_precedence(tokens[i].str[0]);
+            if (prec <= min_prec) {
+                min_prec = prec;
+                min_prec_pos = i;
+            }
+        }
+    }
+    return min_prec_pos;
+}
+
+// Forward-mode automatic differentiation: value and exact partials in x and y
+Dual evaluate_dual(const Token* tokens, int num_tokens, double x, double y) {
+    Dual zero = {0, 0, 0};
+    if (num_tokens == 0) return zero;
+
+    if (num_tokens == 1) {
+        const Token* token = &tokens[0];
+        if (token->type == TOKEN_NUMBER) return (Dual){token->value, 0, 0};
+        if (token->type == TOKEN_PARAMETER) return (Dual){*token->slot, 0, 0};
+        if (token->type == TOKEN_VARIABLE) {
+            if (strcmp(token->str, "x") == 0) return (Dual){x, 1, 0};
+            if (strcmp(token->str, "y") == 0) return (Dual){y, 0, 1};
+        }
+        return zero;
+    }
+
+    int split = find_split_operator(tokens, num_tokens);
+    if (split == -1) {
+        if (tokens[0].type == TOKEN_FUNCTION) {
+            Dual a = evaluate_dual(tokens + 2, num_tokens - 3, x, y);
+            double v, d;  // f(a) and f'(a)
+            if (strcmp(tokens[0].str, "sin") == 0) { v = sin(a.value); d = cos(a.value); }
+            else if (strcmp(tokens[0].str, "cos") == 0) { v = cos(a.value); d = -sin(a.value); }
+            else if (strcmp(tokens[0].str, "tan") == 0) { v = tan(a.value); d = 1 + v * v; }
+            else if (strcmp(tokens[0].str, "log") == 0) { v = log10(a.value); d = 1 / (a.value * log(10)); }
+            else if (strcmp(tokens[0].str, "ln") == 0) { v = log(a.value); d = 1 / a.value; }
+            else if (strcmp(tokens[0].str, "exp") == 0) { v = exp(a.value); d = v; }
+            else if (strcmp(tokens[0].str, "atan") == 0) { v = atan(a.value); d = 1 / (1 + a.value * a.value); }
+            else return zero;
+            return (Dual){v, d * a.dx, d * a.dy};
+        }
+        if (tokens[0].type == TOKEN_LPAREN && tokens[num_tokens-1].type == TOKEN_RPAREN) {
+            return evaluate_dual(tokens + 1, num_tokens - 2, x, y);
+        }
+        return zero;
+    }
+
+    Dual a = evaluate_dual(tokens, split, x, y);
+    Dual b = evaluate_dual(tokens + split + 1, num_tokens - split - 1, x, y);
+
+    switch (tokens[split].str[0]) {
+        case '+': return (Dual){a.value + b.value, a.dx + b.dx, a.dy + b.dy};
+        case '-': return (Dual){a.value - b.value, a.dx - b.dx, a.dy - b.dy};
+        case '*': return (Dual){a.value * b.value, a.dx * b.value + a.value * b.dx, 
+                                a.dy * b.value + a.value * b.dy};
+        case '/': {
+            if (b.value == 0) return (Dual){INFINITY, 0, 0};
+            double q = a.value / b.value;
+            return (Dual){q, (a.dx - q * b.dx) / b.value, (a.dy - q * b.dy) / b.value};
+        }
+        case '^': {
+            double p = pow(a.value, b.value);
+            // Constant exponents stay valid for negative bases
+            if (b.dx == 0 && b.dy == 0) {
+                double d = b.value * pow(a.value, b.value - 1);
+                return (Dual){p, d * a.dx, d * a.dy};
+            }
+            double ln_a = log(a.value);
+            return (Dual){p, p * (b.dx * ln_a + b.value * a.dx / a.value), 
+                          p * (b.dy * ln_a + b.value * a.dy / a.value)};
+        }
+        default: return zero;
+    }
+}
+
+// Second-order forward mode in x alone, with y held fixed: f, f' and f''
+Jet evaluate_jet(const Token* tokens, int num_tokens, double x, double y) {
+    Jet zero = {0, 0, 0};
+    if (num_tokens == 0) return zero;
+
+    if (num_tokens == 1) {
+        const Token* token = &tokens[0];
+        if (token->type == TOKEN_NUMBER) return (Jet){token->value, 0, 0};
+        if (token->type == TOKEN_PARAMETER) return (Jet){*token->slot, 0, 0};
+        if (token->type == TOKEN_VARIABLE) {
+            if (strcmp(token->str, "x") == 0) return (Jet){x, 1, 0};
+            if (strcmp(token->str, "y") == 0) return (Jet){y, 0, 0};
+        }
+        return zero;
+    }
+
+    int split = find_split_operator(tokens, num_tokens);
+    if (split == -1) {
+        if (tokens[0].type == TOKEN_FUNCTION) {
+            Jet a = evaluate_jet(tokens + 2, num_tokens - 3, x, y);
+            double v, d, dd;  // f(a), f'(a) and f''(a)
+            if (strcmp(tokens[0].str, "sin") == 0) { v = sin(a.value); d = cos(a.value); dd = -v; }
+            else if (strcmp(tokens[0].str, "cos") == 0) { v = cos(a.value); d = -sin(a.value); dd = -v; }
+            else if (strcmp(tokens[0].str, "tan") == 0) { v = tan(a.value); d = 1 + v * v; dd = 2 * v * d; }
+            else if (strcmp(tokens[0].str, "log") == 0) {
+                v = log10(a.value); d = 1 / (a.value * log(10)); dd = -d / a.value;
+            }
+            else if (strcmp(tokens[0].str, "ln") == 0) { v = log(a.value); d = 1 / a.value; dd = -d * d; }
+            else if (strcmp(tokens[0].str, "exp") == 0) { v = exp(a.value); d = v; dd = v; }
+            else if (strcmp(tokens[0].str, "atan") == 0) {
+                v = atan(a.value); d = 1 / (1 + a.value * a.value); dd = -2 * a.value * d * d;
+            }
+            else return zero;
+            return (Jet){v, d * a.d1, dd * a.d1 * a.d1 + d * a.d2};
+        }
+        if (tokens[0].type == TOKEN_LPAREN && tokens[num_tokens-1].type == TOKEN_RPAREN) {
+            return evaluate_jet(tokens + 1, num_tokens - 2, x, y);
+        }
+        return zero;
+    }
+
+    Jet a = evaluate_jet(tokens, split, x, y);
+    Jet b = evaluate_jet(tokens + split + 1, num_tokens - split - 1, x, y);
+
+    switch (tokens[split].str[0]) {
+        case '+': return (Jet){a.value + b.value, a.d1 + b.d1, a.d2 + b.d2};
+        case '-': return (Jet){a.value - b.value, a.d1 - b.d1, a.d2 - b.d2};
+        case '*': return (Jet){a.value * b.value, a.d1 * b.value + a.value * b.d1, 
+                               a.d2 * b.value + 2 * a.d1 * b.d1 + a.value * b.d2};
+        case '/': {
+            if (b.value == 0) return (Jet){INFINITY, 0, 0};
+            double q = a.value / b.value;
+            double q1 = (a.d1 - q * b.d1) / b.value;
+            return (Jet){q, q1, (a.d2 - 2 * q1 * b.d1 - q * b.d2) / b.value};
+        }
+        case '^': {
+            double p = pow(a.value, b.value);
+            // Constant exponents stay valid for negative bases; the power rule's terms
+            // vanish outright for exponents 0 and 1, where a^(n-1) or a^(n-2) may not exist
+            if (b.d1 == 0 && b.d2 == 0) {
+                double n = b.value;
+                double d = n == 0 ? 0 : n * pow(a.value, n - 1);
+                double dd = n == 0 || n == 1 ? 0 : n * (n - 1) * pow(a.value, n - 2);
+                return (Jet){p, d * a.d1, dd * a.d1 * a.d1 + d * a.d2};
+            }
+            // a^b = exp(b ln a)
+            double l1 = a.d1 / a.value, l2 = a.d2 / a.value - l1 * l1;
+            double ln_a = log(a.value);
+            double h1 = b.d1 * ln_a + b.value * l1;
+            double h2 = b.d2 * ln_a + 2 * b.d1 * l1 + b.value * l2;
+            return (Jet){p, p * h1, p * (h2 + h1 * h1)};
+        }
+        default: return zero;
+    }
+}
+
+static const Interval INTERVAL_ENTIRE = {-INFINITY, INFINITY};
+
+// Build an interval from possibly unordered bounds, rounded outward by one ulp since
+// the arithmetic below isn't done with directed rounding
+static Interval interval_hull(double a, double b) {
+    if (isnan(a) || isnan(b)) return INTERVAL_ENTIRE;
+    Interval r = {a < b ? a : b, a < b ? b : a};
+    r.lo = nextafter(r.lo, -INFINITY);
+    r.hi = nextafter(r.hi, INFINITY);
+    return r;
+}
+
+static Interval interval_mul(Interval a, Interval b) {
+    double p[4] = {a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi};
+    double lo = p[0], hi = p[0];
+    for (int i = 1; i < 4; i++) {
+        if (isnan(p[i])) return INTERVAL_ENTIRE;
+        if (p[i] < lo) lo = p[i];
+        if (p[i] > hi) hi = p[i];
+    }
+    return interval_hull(lo, hi);
+}
+
+static Interval interval_sin(Interval a) {
+    if (isinf(a.lo) || isinf(a.hi) || a.hi - a.lo >= 2 * PI) return (Interval){-1, 1};
+    Interval r = interval_hull(sin(a.lo), sin(a.hi));
+    // Extremes inside the interval: maxima at pi/2 + 2k*pi, minima at -pi/2 + 2k*pi
+    if (PI / 2 + 2 * PI * ceil((a.lo - PI / 2) / (2 * PI)) <= a.hi) r.hi = 1;
+    if (-PI / 2 + 2 * PI * ceil((a.lo + PI / 2) / (2 * PI)) <= a.hi) r.lo = -1;
+    return r;
+}
+
+static Interval interval_pow(Interval a, Interval b, int* undefined) {
+    // Point integer exponent: monotone on each side of zero
+    if (a.lo <= a.hi && b.lo == b.hi && b.lo == floor(b.lo) && fabs(b.lo) < 1e9) {
+        double n = b.lo;
+        if (n == 0) return (Interval){1, 1};
+        // Negative powers blow up when the base interval straddles zero
+        if (n < 0 && a.lo <= 0 && a.hi >= 0) return INTERVAL_ENTIRE;
+        if (fmod(n, 2) != 0 || a.lo >= 0 || a.hi <= 0) {
+            return interval_hull(pow(a.lo, n), pow(a.hi, n));
+        }
+        // Even power of an interval containing zero
+        double m = fabs(a.lo) > fabs(a.hi) ? fabs(a.lo) : fabs(a.hi);
+        return interval_hull(0, pow(m, n));
+    }
+    // Positive base: pow is monotone in each argument, so the corners bound it
+    if (a.lo > 0) {
+        double p[4] = {pow(a.lo, b.lo), pow(a.lo, b.hi), pow(a.hi, b.lo), pow(a.hi, b.hi)};
+        double lo = p[0], hi = p[0];
+        for (int i = 1; i < 4; i++) {
+            if (p[i] < lo) lo = p[i];
+            if (p[i] > hi) hi = p[i];
+        }
+        return interval_hull(lo, hi);
+    }
+    // A fractional power of a base that may be negative
+    if (undefined) *undefined = 1;
+    return INTERVAL_ENTIRE;
+}
+
+// Interval evaluation: encloses every value of the expression over the box x_range * y_range.
+// Anything the evaluator can't bound comes back as the entire real line. The enclosure
+// only covers points where the expression is defined; when undefined is non-NULL it is
+// set if the box may reach outside the domain, such as log of a non-positive value.
+Interval evaluate_interval(const Token* tokens, int num_tokens, Interval x_range, Interval y_range, 
+                           int* undefined) {
+    Interval zero = {0, 0};
+    if (num_tokens == 0) return zero;
+
+    if (num_tokens == 1) {
+        const Token* token = &tokens[0];
+        if (token->type == TOKEN_NUMBER) return (Interval){token->value, token->value};
+        if (token->type == TOKEN_PARAMETER) return (Interval){*token->slot, *token->slot};
+        if (token->type == TOKEN_VARIABLE) {
+            if (strcmp(token->str, "x") == 0) return x_range;
+            if (strcmp(token->str, "y") == 0) return y_range;
+        }
+        return zero;
+    }
+
+    int split = find_split_operator(tokens, num_tokens);
+    if (split == -1) {
+        if (tokens[0].type == TOKEN_FUNCTION) {
+            Interval a = evaluate_interval(tokens + 2, num_tokens - 3, x_range, y_range, undefined);
+            const char* f = tokens[0].str;
+            if (strcmp(f, "sin") == 0) return interval_sin(a);
+            if (strcmp(f, "cos") == 0) return interval_sin((Interval){a.lo + PI / 2, a.hi + PI / 2});
+            if (strcmp(f, "tan") == 0) {
+                // Poles at pi/2 + k*pi
+                if (isinf(a.lo) || isinf(a.hi) || PI / 2 + PI * ceil((a.lo - PI / 2) / PI) <= a.hi) {
+                    return INTERVAL_ENTIRE;
+                }
+                return interval_hull(tan(a.lo), tan(a.hi));
+            }
+            if (strcmp(f, "log") == 0 || strcmp(f, "ln") == 0) {
+                double (*fn)(double) = strcmp(f, "log") == 0 ? log10 : log;
+                if (a.lo <= 0 && undefined) *undefined = 1;
+                if (a.hi <= 0) return INTERVAL_ENTIRE;
+                return interval_hull(a.lo > 0 ? fn(a.lo) : -INFINITY, fn(a.hi));
+            }
+            if (strcmp(f, "exp") == 0) return interval_hull(exp(a.lo), exp(a.hi));
+            if (strcmp(f, "atan") == 0) return interval_hull(atan(a.lo), atan(a.hi));
+            return zero;
+        }
+        if (tokens[0].type == TOKEN_LPAREN && tokens[num_tokens-1].type == TOKEN_RPAREN) {
+            return evaluate_interval(tokens + 1, num_tokens - 2, x_range, y_range, undefined);
+        }
+        return zero;
+    }
+
+    Interval a = evaluate_interval(tokens, split, x_range, y_range, undefined);
+    Interval b = evaluate_interval(tokens + split + 1, num_tokens - split - 1, x_range, y_range, undefined);
+
+    switch (tokens[split].str[0]) {
+        case '+': return interval_hull(a.lo + b.lo, a.hi + b.hi);
+        case '-': return interval_hull(a.lo - b.hi, a.hi - b.lo);
+        case '*': return interval_mul(a, b);
+        case '/':
+            if (b.lo <= 0 && b.hi >= 0) return INTERVAL_ENTIRE;
+            return interval_mul(a, interval_hull(1 / b.hi, 1 / b.lo));
+        case '^': return interval_pow(a, b, undefined);
+        default: return zero;
+    }
+}
+
+static int shape_free_of_y(ShapeKind kind) {
+    return kind == SHAPE_CONSTANT || kind == SHAPE_FREE;
+}
+
+static ExprShape shape_constant(double value) {
+    return (ExprShape){SHAPE_CONSTANT, value, 0, 0, 0};
+}
+
+// Shape of a op b for one of + - * / ^, folding constants and tracking how y enters
+ExprShape combine_shapes(ExprShape a, ExprShape b, char op) {
+    ExprShape r = {SHAPE_GENERAL, 0, 0, a.uses_x || b.uses_x, a.flags | b.flags};
+    if (a.kind == SHAPE_CONSTANT && b.kind == SHAPE_CONSTANT) {
+        switch (op) {
+            case '+': r.value = a.value + b.value; break;
+            case '-': r.value = a.value - b.value; break;
+            case '*': r.value = a.value * b.value; break;
+            case '/': r.value = a.value / b.value; break;
+            default: r.value = pow(a.value, b.value); break;
+        }
+        r.kind = SHAPE_CONSTANT;
+    } else if (shape_free_of_y(a.kind) && shape_free_of_y(b.kind)) {
+        r.kind = SHAPE_FREE;
+    } else if ((op == '+' || op == '-') && (a.kind == SHAPE_AFFINE || shape_free_of_y(a.kind)) && 
+               (b.kind == SHAPE_AFFINE || shape_free_of_y(b.kind))) {
+        double ca = a.kind == SHAPE_AFFINE ? a.coef : 0, cb = b.kind == SHAPE_AFFINE ? b.coef : 0;
+        r.coef = op == '+' ? ca + cb : ca - cb;
+        r.kind = r.coef != 0 ? SHAPE_AFFINE : SHAPE_FREE;
+    } else if (op == '*' && a.kind == SHAPE_CONSTANT && b.kind == SHAPE_AFFINE) {
+        r.coef = a.value * b.coef;
+        r.kind = r.coef != 0 ? SHAPE_AFFINE : SHAPE_FREE;
+    } else if ((op == '*' || op == '/') && a.kind == SHAPE_AFFINE && b.kind == SHAPE_CONSTANT) {
+        r.coef = op == '*' ? a.coef * b.value : a.coef / b.value;
+        r.kind = r.coef != 0 && isfinite(r.coef) ? SHAPE_AFFINE : SHAPE_GENERAL;
+    } else if ((shape_free_of_y(a.kind) || a.kind == SHAPE_PERIODIC) && 
+               (shape_free_of_y(b.kind) || b.kind == SHAPE_PERIODIC)) {
+        r.kind = SHAPE_PERIODIC;
+    }
+
+    // Division by anything but a nonzero constant, or a negative constant power of
+    // a non-constant, can blow up
+    if (op == '/' && (b.kind != SHAPE_CONSTANT || b.value == 0)) r.flags |= ANALYSIS_POLES;
+    if (op == '^' && a.kind != SHAPE_CONSTANT && (b.kind != SHAPE_CONSTANT || b.value < 0)) {
+        r.flags |= ANALYSIS_POLES;
+    }
+    return r;
+}
+
+// Compile-time analysis mirroring evaluate_expression: how y enters the expression,
+// which variables feed periodic functions and which functions restrict the domain
+ExprShape analyze_expression(const Token* tokens, int num_tokens) {
+    if (num_tokens == 0) return shape_constant(0);
+
+    if (num_tokens == 1) {
+        const Token* token = &tokens[0];
+        if (token->type == TOKEN_NUMBER) return shape_constant(token->value);
+        // Like x, a parameter is free of y but has no fixed value
+        if (token->type == TOKEN_PARAMETER) return (ExprShape){SHAPE_FREE, 0, 0, 0, ANALYSIS_PARAMETER};
+        if (token->type == TOKEN_VARIABLE) {
+            if (strcmp(token->str, "x") == 0) return (ExprShape){SHAPE_FREE, 0, 0, 1, 0};
+            if (strcmp(token->str, "y") == 0) return (ExprShape){SHAPE_AFFINE, 0, 1, 0, 0};
+        }
+        return shape_constant(0);
+    }
+
+    int split = find_split_operator(tokens, num_tokens);
+    if (split == -1) {
+        if (tokens[0].type == TOKEN_FUNCTION) {
+            ExprShape a = analyze_expression(tokens + 2, num_tokens - 3);
+            const char* f = tokens[0].str;
+            int periodic = strcmp(f, "sin") == 0 || strcmp(f, "cos") == 0 || strcmp(f, "tan") == 0;
+            double (*fn)(double) = strcmp(f, "sin") == 0 ? sin : strcmp(f, "cos") == 0 ? cos : 
+                                   strcmp(f, "tan") == 0 ? tan : strcmp(f, "log") == 0 ? log10 : 
+                                   strcmp(f, "ln") == 0 ? log : strcmp(f, "exp") == 0 ? exp : 
+                                   strcmp(f, "atan") == 0 ? atan : NULL;
+            if (!fn) return shape_constant(0);
+
+            ExprShape r = a;
+            if (periodic) {
+                r.flags |= strcmp(f, "tan") == 0 ? ANALYSIS_POLES : ANALYSIS_SIN_COS;
+                if (a.uses_x) r.flags |= ANALYSIS_X_PERIODIC;
+                if (!shape_free_of_y(a.kind)) r.flags |= ANALYSIS_Y_PERIODIC;
+            } else if (fn == log10 || fn == log) {
+                r.flags |= ANALYSIS_LOG;
+            }
+
+            if (a.kind == SHAPE_CONSTANT) {
+                r.value = fn(a.value);
+            } else if (a.kind == SHAPE_AFFINE) {
+                // sin(n*y + ...) repeats every 2*pi in y only for whole n
+                r.kind = periodic && a.coef == floor(a.coef) ? SHAPE_PERIODIC : SHAPE_GENERAL;
+            } else if (a.kind != SHAPE_FREE && a.kind != SHAPE_PERIODIC) {
+                r.kind = SHAPE_GENERAL;
+            }
+            return r;
+        }
+        if (tokens[0].type == TOKEN_LPAREN && tokens[num_tokens-1].type == TOKEN_RPAREN) {
+            return analyze_expression(tokens + 1, num_tokens - 2);
+        }
+        return shape_constant(0);
+    }
+
+    ExprShape a = analyze_expression(tokens, split);
+    ExprShape b = analyze_expression(tokens + split + 1, num_tokens - split - 1);
+    char op = tokens[split].str[0];
+    if (op != '+' && op != '-' && op != '*' && op != '/' && op != '^') return shape_constant(0);
+    return combine_shapes(a, b, op);
+}
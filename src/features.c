@@ -0,0 +1,112 @@
+// Feature points of explicit curves y = f(x): zeros, extrema and inflections are sign
+// changes of f, f' and f'' between samples the frame already solved, each refined by a
+// bracketed root finder on second-order forward-mode derivatives
+#include "graphcalc_internal.h"
+
+// f, f' and f'' at x: the residual is coef * y + g(x), so f = -g / coef
+static Jet explicit_jet(const Equation* eq, double x) {
+    Jet l = evaluate_jet(eq->left_tokens, eq->left_num_tokens, x, 0);
+    Jet r = evaluate_jet(eq->right_tokens, eq->right_num_tokens, x, 0);
+    double scale = -1 / eq->analysis.y_coef;
+    return (Jet){(l.value - r.value) * scale, (l.d1 - r.d1) * scale, (l.d2 - r.d2) * scale};
+}
+
+// The order-th derivative held in a jet
+static double jet_term(Jet jet, int order) {
+    return order == 0 ? jet.value : (order == 1 ? jet.d1 : jet.d2);
+}
+
+// Illinois false position for a zero of the order-th derivative of f in [a, b], where
+// it takes the values ga and gb of opposite signs. Bisects whenever the secant falls
+// outside the bracket, and stops once the bracket is a few ulps wide.
+static double bracket_root(const Equation* eq, int order, double a, double b, double ga, 
+                           double gb, double cell) {
+    int side = 0;
+    for (int iter = 0; iter < FEATURE_MAX_ITER; iter++) {
+        if (b - a <= 4 * DBL_EPSILON * (fabs(a) + fabs(b) + cell)) break;
+        double c = (a * gb - b * ga) / (gb - ga);
+        if (!(c > a && c < b)) c = 0.5 * (a + b);
+        double gc = jet_term(explicit_jet(eq, c), order);
+        if (gc == 0) return c;
+        if (!isfinite(gc)) return NAN;
+        if ((gc > 0) == (gb > 0)) {
+            b = c;
+            gb = gc;
+            if (side == -1) ga *= 0.5;
+            side = -1;
+        } else {
+            a = c;
+            ga = gc;
+            if (side == 1) gb *= 0.5;
+            side = 1;
+        }
+    }
+    return fabs(ga) < fabs(gb) ? a : b;
+}
+
+// Record the feature at x unless it falls outside the view or the list is full
+static int add_feature(const Equation* eq, int index, int order, int rising, double x, 
+                       PlotSettings settings, Marker* features, int count) {
+    // Zeros are listed on y = 0 itself, so that is the row that has to be in view
+    Jet jet = explicit_jet(eq, x);
+    double y = order == 0 || jet.value == 0 ? 0.0 : jet.value;
+    double row = floor(GRID_HEIGHT / 2 - (y - settings.y_offset) * 5.0 * settings.zoom);
+    double col = floor(GRID_WIDTH / 2 + (x - settings.x_offset) * 5.0 * settings.zoom);
+    if (count >= MAX_FEATURES || !(row >= 0 && row < GRID_HEIGHT && col >= 0 && col < GRID_WIDTH)) {
+        return count;
+    }
+
+    static const char* const names[] = {"zero", "maximum", "minimum", "inflection"};
+    static const char glyphs[] = {ZERO_GLYPH, MAXIMUM_GLYPH, MINIMUM_GLYPH, INFLECTION_GLYPH};
+    int kind = order == 0 ? 0 : (order == 1 ? (rising ? 2 : 1) : 3);
+    Marker* feature = &features[count];
+    feature->x = x;
+    feature->y = y;
+    feature->glyph = glyphs[kind];
+    snprintf(feature->label, sizeof(feature->label), "%s of curve %d", names[kind], index + 1);
+    return count + 1;
+}
+
+// Append the feature points of eq, curve number index, to features. xs are the frame's
+// solved x samples in order and joined[i] says whether the curve runs unbroken from
+// sample i - 1 to i; sign changes are only trusted within unbroken runs, so poles and
+// gaps are never mistaken for zeros. Returns the new count.
+int find_features(const Equation* eq, int index, const double* xs, const unsigned char* joined, 
+                  int n, PlotSettings settings, Marker* features, int count) {
+    double cell = 1.0 / (5.0 * settings.zoom);
+    Jet* jets = malloc(n * sizeof(Jet));
+    if (!jets) return count;
+    for (int i = 0; i < n; i++) jets[i] = explicit_jet(eq, xs[i]);
+
+    for (int order = 0; order < 3; order++) {
+        int last = -1;  // Last sample of the current run with a nonzero term
+        for (int i = 0; i < n; i++) {
+            if (!joined[i]) last = -1;
+            double g = jet_term(jets[i], order);
+            if (!isfinite(g)) {
+                last = -1;
+                continue;
+            }
+            if (g == 0) {
+                // A sample right on a zero of f counts whether or not f changes sign
+                if (order == 0 && (i == 0 || jet_term(jets[i - 1], 0) != 0)) {
+                    count = add_feature(eq, index, 0, 0, xs[i], settings, features, count);
+                }
+                continue;
+            }
+
+            double g_last = last >= 0 ? jet_term(jets[last], order) : 0;
+            if (last >= 0 && (g > 0) != (g_last > 0)) {
+                // Samples exactly on the zero lie between last and i; otherwise solve for it
+                double x = last + 1 < i ? xs[(last + 1 + i) / 2] : 
+                           bracket_root(eq, order, xs[last], xs[i], g_last, g, cell);
+                if (isfinite(x) && !(order == 0 && last + 1 < i)) {
+                    count = add_feature(eq, index, order, g > 0, x, settings, features, count);
+                }
+            }
+            last = i;
+        }
+    }
+    free(jets);
+    return count;
+}
@@ -0,0 +1,461 @@
+// Types, limits and functions shared by the library sources. Not installed.
+#ifndef GRAPHCALC_INTERNAL_H
+#define GRAPHCALC_INTERNAL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "graphcalc.h"
+
+#define GRID_WIDTH GC_GRID_WIDTH
+#define GRID_HEIGHT GC_GRID_HEIGHT
+#define MAX_EQUATION_LENGTH GC_MAX_EQUATION_LENGTH
+#define MAX_EQUATIONS GC_MAX_EQUATIONS
+#define MAX_TOKENS 100
+#define MAX_ITER 100
+#define MAX_SYMBOLS 32
+#define EPSILON 1e-10
+#define NUM_INITIAL_GUESSES 40
+#define POINTS_PER_COLUMN 10
+#define ADAPTIVE_MAX_DEPTH 4
+#define COLUMN_SLOTS (1 << ADAPTIVE_MAX_DEPTH)
+#define ADAPTIVE_TOLERANCE 0.25
+#define PARAM_INITIAL_SAMPLES 256
+#define PARAM_MAX_DEPTH 10
+#define PARAM_MAX_POINTS (1 << 18)
+#define PARAM_JOIN_CELLS 2.0
+#define REGION_LEAF_CELLS 4
+#define REGION_GLYPH '.'
+#define MAX_CONTOUR_LEVELS 32
+#define CONTOUR_DEFAULT_LEVELS 10
+#define CONTOUR_SUBDIV 4
+#define CONTOUR_GLYPHS "0123456789ABCDEFGHIJKLMNOPQRSTUV"
+#define HEAT_SUPERSAMPLE 2
+#define HEAT_RAMP_STEPS 16
+#define DERIVATIVE_GLYPH '\''
+#define INTEGRAL_GLYPH '"'
+#define ANIMATION_BUSY 0.8
+#define ANIMATION_IDLE 0.4
+#define MAX_FEATURES 64
+#define FEATURE_MAX_ITER 100
+#define ZERO_GLYPH 'o'
+#define MAXIMUM_GLYPH '^'
+#define MINIMUM_GLYPH 'v'
+#define INFLECTION_GLYPH '~'
+#define RASTER_BAND_HEIGHT 64
+#define SVG_TOLERANCE_PX 0.5
+#define SVG_BRANCH_GAP 3.0
+#define ROOT_TOLERANCE 1e-6
+#define ROOT_CELL_TOLERANCE 1e-3
+#define POINTS_BLOCK_SIZE 256
+#define POINTS_MAGIC "GCPT"
+#define POINTS_VERSION 1
+#define POINTS_HEADER_SIZE 32
+#define POINTS_RECORD_FIELDS 3
+#define CURVE_GLYPHS "*o#@x%&$=~:;!?^8OXZS"
+#define NUM_CURVE_COLORS 12
+#define INTERSECT_DEPTH 8
+#define STATS_HISTOGRAM_BUCKETS 10
+#define PROGRAM_MAX_LENGTH (2 * MAX_TOKENS + 1)
+#define PROGRAM_MAX_STACK 16
+#define BATCH_LANES 64
+#define DEEP_ZOOM_MARGIN 1024.0
+#define DEEP_ZOOM_SOLVER_MARGIN 8.0
+#define DEEP_REFINE_ITER 30
+#define FLOAT_ROW_TOLERANCE 1e-2
+#define FLOAT_NOISE_FACTOR 4.0f
+#define CONTINUITY_MAX_DEPTH 10
+#define CONTINUITY_PROJECT_ITER 20
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+typedef gc_view PlotSettings;
+typedef gc_plot_options PlotOptions;
+typedef gc_marker Marker;
+
+typedef enum {
+    TOKEN_NUMBER,
+    TOKEN_VARIABLE,
+    TOKEN_PARAMETER,  // A session parameter, resolved to its slot at compile time
+    TOKEN_OPERATOR,
+    TOKEN_FUNCTION,
+    TOKEN_LPAREN,
+    TOKEN_RPAREN,
+    TOKEN_EQUALS
+} TokenType;
+
+typedef struct {
+    TokenType type;
+    char str[32];
+    double value;
+    const double* slot;  // TOKEN_PARAMETER only
+} Token;
+
+typedef enum {
+    OP_CONST,
+    OP_X,
+    OP_Y,
+    OP_PARAM,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_POW,
+    OP_SIN,
+    OP_COS,
+    OP_TAN,
+    OP_LOG10,
+    OP_LN,
+    OP_EXP,
+    OP_ATAN
+} OpCode;
+
+typedef struct {
+    OpCode op;
+    double value;        // Only used by OP_CONST
+    const double* slot;  // Only used by OP_PARAM, which pushes the slot's current value
+} Instruction;
+
+// Postfix bytecode for a stack machine; length -1 means the expression needs more
+// than PROGRAM_MAX_STACK slots and callers must use the token evaluator instead
+typedef struct {
+    Instruction code[PROGRAM_MAX_LENGTH];
+    int length;
+} Program;
+
+// Double-double number hi + lo with |lo| <= ulp(hi) / 2
+typedef struct {
+    double hi;
+    double lo;
+} DoubleDouble;
+
+// How an expression depends on y, as found by analyze_expression
+typedef enum {
+    SHAPE_CONSTANT,  // Neither x nor y; value is known
+    SHAPE_FREE,      // x only
+    SHAPE_AFFINE,    // coef * y plus terms free of y
+    SHAPE_PERIODIC,  // y only through 2*pi-periodic functions
+    SHAPE_GENERAL
+} ShapeKind;
+
+// Flags collected by the analysis pass
+#define ANALYSIS_X_PERIODIC 1u  // x feeds sin, cos or tan
+#define ANALYSIS_Y_PERIODIC 2u  // y feeds sin, cos or tan
+#define ANALYSIS_SIN_COS 4u     // sin or cos present
+#define ANALYSIS_LOG 8u         // log or ln: argument must be positive
+#define ANALYSIS_POLES 16u      // tan, or division or a negative power of a non-constant
+#define ANALYSIS_PARAMETER 32u  // Reads a session parameter, whose value may change later
+
+typedef struct {
+    ShapeKind kind;
+    double value;  // SHAPE_CONSTANT
+    double coef;   // SHAPE_AFFINE
+    int uses_x;
+    unsigned flags;
+} ExprShape;
+
+// Facts about an equation fixed at parse time, consulted by the solver
+typedef struct {
+    unsigned flags;
+    ShapeKind shape;  // Of the residual left - right
+    int y_periodic;   // Residual is 2*pi-periodic in y, so roots may be wrapped into [-pi, pi)
+    int explicit_y;   // Residual is coef * y + g(x), so each x has the single root y = f(x)
+    double y_coef;    // coef, when explicit_y
+    double seed_min;  // y range the solver's seeds span
+    double seed_max;
+} EquationAnalysis;
+
+// How the two sides of an implicit equation compare; anything but RELATION_EQUAL
+// shades the region where left - right has the matching sign
+typedef enum {
+    RELATION_EQUAL,
+    RELATION_LESS,
+    RELATION_LESS_EQUAL,
+    RELATION_GREATER,
+    RELATION_GREATER_EQUAL
+} Relation;
+
+typedef enum {
+    EQUATION_IMPLICIT,    // left = right, solved for y at each x
+    EQUATION_PARAMETRIC,  // x = f(t), y = g(t), evaluated directly over [t_min, t_max]
+    EQUATION_POLAR,       // r = f(theta), likewise with theta over [t_min, t_max]
+    EQUATION_CONTOUR      // f(x, y) = a..b, drawn at each of levels with residual f
+} EquationKind;
+
+// Equation with both sides tokenized, ready for repeated solving, plus the
+// residual left - right compiled for the batch evaluator. Parametric equations
+// keep x(t) and y(t) in the left and right tokens instead, with t read as x; polar
+// ones keep r(theta) on the left.
+typedef struct gc_equation {
+    char text[MAX_EQUATION_LENGTH];
+    Token left_tokens[MAX_TOKENS];
+    int left_num_tokens;
+    Token right_tokens[MAX_TOKENS];
+    int right_num_tokens;
+    Program residual;
+    EquationAnalysis analysis;
+    EquationKind kind;
+    Relation relation;
+    Program curve_x;  // Parametric and polar only
+    Program curve_y;
+    double t_min;
+    double t_max;
+    double levels[MAX_CONTOUR_LEVELS];  // Contour only
+    int num_levels;
+    char undefined[32];  // First name that is neither a variable nor a symbol, or ""
+} Equation;
+
+// Points of a traced parametric curve in t order
+typedef struct {
+    double* x;
+    double* y;
+    int count;
+} CurveTrace;
+
+// Forward-mode dual number: a value and its partial derivatives in x and y
+typedef struct {
+    double value;
+    double dx;
+    double dy;
+} Dual;
+
+// Truncated Taylor series in x at fixed y: a value and its first two x-derivatives
+typedef struct {
+    double value;
+    double d1;
+    double d2;
+} Jet;
+
+// Closed interval [lo, hi]; infinite bounds mean "unbounded"
+typedef struct {
+    double lo;
+    double hi;
+} Interval;
+
+// Join decisions already made for one sampling step, keyed by the root pair
+typedef struct {
+    double x0[NUM_INITIAL_GUESSES];
+    double from[NUM_INITIAL_GUESSES];
+    double to[NUM_INITIAL_GUESSES];
+    int connected[NUM_INITIAL_GUESSES];
+    int count;
+} JoinCache;
+
+// One rendered character frame: glyphs plus the curve owning each cell (-1 for none)
+typedef struct gc_frame {
+    char grid[GRID_HEIGHT][GRID_WIDTH];
+    signed char owner[GRID_HEIGHT][GRID_WIDTH];
+    Marker features[MAX_FEATURES];      // Feature points found by the last render
+    int num_features;
+    gc_heat_map heat_map;               // GC_HEAT_OFF when the last render made no heat map
+    int heat[GRID_HEIGHT][GRID_WIDTH];  // Background colour of each cell, -1 for none
+} Frame;
+
+// Callback used by draw_line to set a single point on some target surface
+typedef void (*PlotPointFn)(void* target, int x, int y);
+
+typedef enum {
+    STAGE_PARSE,
+    STAGE_SOLVE,
+    STAGE_RASTERIZE,
+    STAGE_EMIT,
+    NUM_STAGES
+} FrameStage;
+
+typedef struct {
+    double stage_seconds[NUM_STAGES];
+    uint64_t residual_evaluations;
+    uint64_t newton_iterations;
+    uint64_t max_iter_failures;
+    uint64_t roots_found;
+    uint64_t roots_distinct;
+    uint64_t float_rechecks;
+    uint64_t continuity_projections;
+    uint64_t x_samples;
+    uint64_t parametric_points;
+    uint64_t region_tiles;
+    uint64_t region_cells;
+    uint64_t contour_samples;
+    uint64_t heat_samples;
+    // Iterations per solve in buckets of MAX_ITER / STATS_HISTOGRAM_BUCKETS; failures separate
+    uint64_t iteration_histogram[STATS_HISTOGRAM_BUCKETS];
+} FrameStats;
+
+// Session symbol: a parameter, read by compiled equations through the address of
+// value, or a one-argument function kept as its body with symbols already resolved
+typedef struct {
+    char name[32];
+    int is_function;
+    double value;
+    char argument[32];
+    Token body[MAX_TOKENS];
+    int body_num_tokens;
+} Symbol;
+
+// Symbols never move once defined, so the slots equations point at stay valid for
+// the context's lifetime
+typedef struct {
+    Symbol symbols[MAX_SYMBOLS];
+    int count;
+} SymbolTable;
+
+// Per-thread state handed through the pipeline; may be NULL everywhere
+typedef struct gc_context {
+    FrameStats stats;
+    gc_precision precision;
+    int float_mismatches;  // Cells that differed in the last validated frame, or -1
+    unsigned overlays;     // GC_OVERLAY_* flags
+    gc_heat_map heat_map;  // Heat map computed with each frame
+    int refine_depth;      // Adaptive refinement levels per column, up to ADAPTIVE_MAX_DEPTH
+    SymbolTable symbols;
+} Context;
+
+// Per-curve colours for ANSI terminals and image exports, in matching order
+extern const int ANSI_CURVE_COLORS[NUM_CURVE_COLORS];
+extern const unsigned char RGB_CURVE_COLORS[NUM_CURVE_COLORS][3];
+
+// Per-frame instrumentation, compiled in only with -DGRAPHCALC_STATS (make STATS=1).
+// Without it the macros below expand to nothing and cost nothing.
+#ifdef GRAPHCALC_STATS
+double stats_now(void);
+void stats_record_solve(Context* ctx, int iterations);
+#define STATS_ADD(ctx, field, n) \
+    do { if (ctx) __atomic_fetch_add(&(ctx)->stats.field, (uint64_t)(n), __ATOMIC_RELAXED); } while (0)
+#define STATS_TIMER_START(name) double name = stats_now()
+#define STATS_TIMER_STOP(ctx, stage, name) \
+    do { if (ctx) (ctx)->stats.stage_seconds[stage] += stats_now() - (name); } while (0)
+#else
+#define STATS_ADD(ctx, field, n) ((void)(ctx), (void)(n))
+#define STATS_TIMER_START(name) ((void)0)
+#define STATS_TIMER_STOP(ctx, stage, name) ((void)(ctx))
+#define stats_record_solve(ctx, iterations) ((void)(ctx))
+#endif
+void stats_reset(Context* ctx);
+int stats_print(const Context* ctx, FILE* out);
+
+// Tokenizer (tokenizer.c)
+int is_operator(char c);
+int is_function(const char* str);
+int get_precedence(char op);
+int tokenize_expression(const char* expr, Token* tokens);
+
+// Session constants and user functions (symbols.c)
+int define_symbol(SymbolTable* table, const char* text);
+int resolve_symbols(const SymbolTable* table, Token* tokens, int num_tokens, const char* keep);
+int tokenize_resolved(const SymbolTable* table, const char* expr, Token* tokens);
+void mark_undefined(Token* tokens, int num_tokens, const char* first, const char* second, 
+                    char* undefined);
+double* parameter_slot(SymbolTable* table, const char* name);
+
+// Evaluators (evaluator.c)
+double evaluate_expression(Token* tokens, int num_tokens, double x, double y);
+double evaluate_constant(const char* text);
+Dual evaluate_dual(const Token* tokens, int num_tokens, double x, double y);
+Jet evaluate_jet(const Token* tokens, int num_tokens, double x, double y);
+Interval evaluate_interval(const Token* tokens, int num_tokens, Interval x_range, Interval y_range, 
+                           int* undefined);
+ExprShape analyze_expression(const Token* tokens, int num_tokens);
+ExprShape combine_shapes(ExprShape a, ExprShape b, char op);
+
+// Bytecode compiler and the ISA-dispatched batch evaluator (program.c)
+void compile_residual(const Equation* eq, Program* program);
+void compile_program(const Token* tokens, int num_tokens, Program* program);
+void program_eval_batch(const Program* program, const double* x, const double* y, 
+                        double* out, int n);
+void program_eval_batch_float(const Program* program, const float* x, const float* y, 
+                              float* out, float* scale, int n);
+const char* program_isa(void);
+
+// Double-double arithmetic and the deep-zoom evaluator (ddouble.c)
+DoubleDouble dd_from(double a);
+DoubleDouble dd_add(DoubleDouble a, DoubleDouble b);
+DoubleDouble dd_add_d(DoubleDouble a, double b);
+DoubleDouble dd_sub(DoubleDouble a, DoubleDouble b);
+DoubleDouble program_eval_dd(const Program* program, DoubleDouble x, DoubleDouble y);
+int view_needs_double_double(PlotSettings settings);
+
+// Solver (solver.c)
+void parse_equation(const char* equation, const SymbolTable* symbols, Equation* eq);
+double solve_equation_counted(const Equation* eq, double x, double initial_y, int* iterations);
+double solve_equation(const Equation* eq, double x, double initial_y);
+void get_seed_range(const Equation* eq, double* y_min, double* y_max);
+void sample_roots(Context* ctx, const Equation* eq, double x_val, double y_min, double y_max, 
+                  double* roots);
+void sample_all_roots(Context* ctx, const Equation* const* eqs, int num_equations, double x_val, 
+                      double* roots);
+int view_fits_float(PlotSettings settings);
+void sample_all_roots_float(Context* ctx, const Equation* const* eqs, int num_equations, 
+                            double x_val, PlotSettings settings, double* roots);
+void sample_all_roots_deep(Context* ctx, const Equation* const* eqs, int num_equations, 
+                           DoubleDouble x_val, PlotSettings settings, double* offsets);
+int collect_distinct_roots(const double* roots, int num_roots, double tolerance, double* distinct);
+
+// Parametric and polar curves (parametric.c)
+int parse_parametric(Equation* eq, const SymbolTable* symbols);
+int trace_parametric(Context* ctx, const Equation* eq, PlotSettings settings, CurveTrace* trace);
+void free_curve_trace(CurveTrace* trace);
+
+// Inequality regions (region.c)
+int relation_holds(Relation relation, double f);
+int shade_region(Context* ctx, const Equation* eq, double x_min, double y_max, double cell, 
+                 int width, int height, unsigned char* mask);
+
+// Contour plots (contour.c)
+int parse_levels(const char* text, double* levels);
+int contour_levels(Context* ctx, const Equation* eq, double x_min, double y_max, double cell, 
+                   int width, int height, signed char* cells);
+
+// Heat maps (heatmap.c)
+int heat_map_colors(Context* ctx, const Equation* eq, PlotSettings settings, gc_heat_map mode, 
+                    int* colors);
+
+// Intersections (intersect.c)
+Interval residual_interval(const Equation* eq, Interval x_range, Interval y_range, int* undefined);
+Dual residual_dual(const Equation* eq, double x, double y);
+int newton_intersection(const Equation* a, const Equation* b, double* x, double* y);
+int find_intersections(const Equation* a, const Equation* b, PlotSettings settings, 
+                       double* xs, double* ys, int max_points);
+
+// Zeros, extrema and inflections of explicit curves (features.c)
+int find_features(const Equation* eq, int index, const double* xs, const unsigned char* joined, 
+                  int n, PlotSettings settings, Marker* features, int count);
+
+// Discontinuity detection for joins (continuity.c)
+int roots_connected(Context* ctx, const Equation* eq, double x0, double y0, 
+                    double x1, double y1, double cell);
+int join_cache_connected(JoinCache* cache, Context* ctx, const Equation* eq, double x0, 
+                         double y0, double x1, double y1, double cell);
+
+// Character frames (render.c)
+void draw_line(int x_start, int y_start, int x_end, int y_end, PlotPointFn plot, void* target);
+int render_frame(Context* ctx, Frame* frame, const Equation* const* eqs, int num_equations, 
+                 PlotSettings settings, const Marker* markers, int num_markers);
+void print_frame(Context* ctx, const Frame* frame, FILE* out, const Equation* const* eqs, 
+                 int num_equations, PlotSettings settings, PlotOptions options, 
+                 const Marker* markers, int num_markers);
+
+// Parameter animation (animate.c)
+double animate_parameter(Context* ctx, const Equation* const* eqs, int num_equations, 
+                         PlotSettings settings, PlotOptions options, const char* name, 
+                         double from, double to, int num_frames, double fps, FILE* out);
+
+// Exports (raster.c, svg.c, points.c)
+int export_raster(const Equation* const* eqs, int num_equations, PlotSettings settings, 
+                  const char* filename, int width, int height, int channels);
+int export_svg(const Equation* const* eqs, int num_equations, PlotSettings settings, 
+               const char* filename, int width, int height);
+int export_points(const Equation* const* eqs, int num_equations, PlotSettings settings, 
+                  const char* filename, int num_samples, int binary);
+
+#endif
@@ -0,0 +1,100 @@
+// Heat maps: the residual F = left - right sampled over the view and mapped to a
+// diverging colour ramp, printed as cell backgrounds behind the character grid
+#include "graphcalc_internal.h"
+
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*)a, fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Ramp position t in [-1, 1] to a colour: blue below zero, red above, dark near the
+// zero set so the curve stays readable on top. Returns an xterm 256-colour index or
+// 0xRRGGBB for true colour. Magnitudes are quantized to HEAT_RAMP_STEPS so that
+// neighbouring cells share colours and coalesce into runs when printed.
+static int ramp_color(float t, gc_heat_map mode) {
+    float m = roundf(fabsf(t) * HEAT_RAMP_STEPS) / HEAT_RAMP_STEPS;
+    int hot = 60 + (int)(195 * m), warm = 30 + (int)(90 * m), cold = 30;
+    int r = t < 0 ? cold : hot, g = warm, b = t < 0 ? hot : cold;
+    if (mode == GC_HEAT_TRUECOLOR) return r << 16 | g << 8 | b;
+    return 16 + 36 * (r * 6 / 256) + 6 * (g * 6 / 256) + b * 6 / 256;
+}
+
+// Fill colors (GRID_HEIGHT rows of GRID_WIDTH) with each cell's heat map colour, or -1
+// where F is undefined. Every cell averages HEAT_SUPERSAMPLE^2 samples, evaluated a
+// sample row at a time through the batch evaluator with rows in parallel. F is
+// scaled by its median magnitude over the view, so the ramp adapts to the field.
+int heat_map_colors(Context* ctx, const Equation* eq, PlotSettings settings, gc_heat_map mode, 
+                    int* colors) {
+    int cols = GRID_WIDTH * HEAT_SUPERSAMPLE, rows = GRID_HEIGHT * HEAT_SUPERSAMPLE;
+    double step = 1.0 / (5.0 * settings.zoom) / HEAT_SUPERSAMPLE;
+    double x_min = settings.x_offset - GRID_WIDTH / 2 / (5.0 * settings.zoom);
+    double y_max = settings.y_offset + GRID_HEIGHT / 2 / (5.0 * settings.zoom);
+    size_t num_samples = (size_t)rows * cols;
+
+    double* field = malloc(num_samples * sizeof(double));
+    double* xs = malloc(cols * sizeof(double));
+    float* magnitudes = malloc(num_samples * sizeof(float));
+    if (!field || !xs || !magnitudes) {
+        free(field);
+        free(xs);
+        free(magnitudes);
+        return -1;
+    }
+    for (int c = 0; c < cols; c++) xs[c] = x_min + (c + 0.5) * step;
+
+    #pragma omp parallel for schedule(static)
+    for (int r = 0; r < rows; r++) {
+        double ys[BATCH_LANES];
+        double y = y_max - (r + 0.5) * step;
+        double* out = field + (size_t)r * cols;
+        for (int i = 0; i < BATCH_LANES; i++) ys[i] = y;
+        for (int c = 0; c < cols; c += BATCH_LANES) {
+            int n = cols - c < BATCH_LANES ? cols - c : BATCH_LANES;
+            if (eq->residual.length >= 0) {
+                program_eval_batch(&eq->residual, xs + c, ys, out + c, n);
+                continue;
+            }
+            for (int i = 0; i < n; i++) {
+                out[c + i] = evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, 
+                                                 xs[c + i], y) - 
+                             evaluate_expression((Token*)eq->right_tokens, eq->right_num_tokens, 
+                                                 xs[c + i], y);
+            }
+        }
+    }
+    free(xs);
+    STATS_ADD(ctx, heat_samples, num_samples);
+
+    size_t num_finite = 0;
+    for (size_t i = 0; i < num_samples; i++) {
+        if (isfinite(field[i])) magnitudes[num_finite++] = (float)fabs(field[i]);
+    }
+    float scale = 1;
+    if (num_finite > 0) {
+        qsort(magnitudes, num_finite, sizeof(float), compare_floats);
+        if (magnitudes[num_finite / 2] > 0) scale = magnitudes[num_finite / 2];
+    }
+    free(magnitudes);
+
+    // Average the ramp positions of each cell's finite samples; t = F / (|F| + scale)
+    // keeps poles and huge values from flattening the rest of the view
+    for (int i = 0; i < GRID_HEIGHT; i++) {
+        for (int j = 0; j < GRID_WIDTH; j++) {
+            float sum = 0;
+            int count = 0;
+            for (int si = 0; si < HEAT_SUPERSAMPLE; si++) {
+                const double* samples = field + (size_t)(i * HEAT_SUPERSAMPLE + si) * cols + 
+                                        j * HEAT_SUPERSAMPLE;
+                for (int sj = 0; sj < HEAT_SUPERSAMPLE; sj++) {
+                    double f = samples[sj];
+                    if (!isfinite(f)) continue;
+                    sum += (float)(f / (fabs(f) + scale));
+                    count++;
+                }
+            }
+            colors[i * GRID_WIDTH + j] = count > 0 ? ramp_color(sum / count, mode) : -1;
+        }
+    }
+    free(field);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Intersections of two curves: interval-pruned quadtree seeding a 2D Newton method
+#include "graphcalc_internal.h"
+
+// Residual F = left - right of an equation, with its partials
+Dual residual_dual(const Equation* eq, double x, double y) {
+    Dual l = evaluate_dual(eq->left_tokens, eq->left_num_tokens, x, y);
+    Dual r = evaluate_dual(eq->right_tokens, eq->right_num_tokens, x, y);
+    return (Dual){l.value - r.value, l.dx - r.dx, l.dy - r.dy};
+}
+
+// Bounds of F over a box; undefined, when non-NULL, is set if F may be undefined in it
+Interval residual_interval(const Equation* eq, Interval x_range, Interval y_range, int* undefined) {
+    Interval l = evaluate_interval(eq->left_tokens, eq->left_num_tokens, x_range, y_range, undefined);
+    Interval r = evaluate_interval(eq->right_tokens, eq->right_num_tokens, x_range, y_range, undefined);
+    return (Interval){l.lo - r.hi, l.hi - r.lo};
+}
+
+static double residual(const Equation* eq, double x, double y) {
+    return evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, x, y) - 
+           evaluate_expression((Token*)eq->right_tokens, eq->right_num_tokens, x, y);
+}
+
+// Newton's method on F1 = F2 = 0 with the Jacobian from forward-mode AD.
+// Returns 0 and the point on convergence, -1 otherwise.
+int newton_intersection(const Equation* a, const Equation* b, double* x, double* y) {
+    for (int iter = 0; iter < MAX_ITER; iter++) {
+        Dual f1 = residual_dual(a, *x, *y);
+        Dual f2 = residual_dual(b, *x, *y);
+        double det = f1.dx * f2.dy - f1.dy * f2.dx;
+        if (!isfinite(det) || fabs(det) < EPSILON * EPSILON) return -1;
+
+        double dx = (f1.value * f2.dy - f2.value * f1.dy) / det;
+        double dy = (f2.value * f1.dx - f1.value * f2.dx) / det;
+        *x -= dx;
+        *y -= dy;
+        if (!isfinite(*x) || !isfinite(*y)) return -1;
+        if (fabs(dx) + fabs(dy) < EPSILON * (1 + fabs(*x) + fabs(*y))) return 0;
+    }
+    return -1;
+}
+
+typedef struct {
+    const Equation* a;
+    const Equation* b;
+    double* xs;
+    double* ys;
+    int count;
+    int max_points;
+    double tolerance;
+} IntersectionSearch;
+
+static int corner_sign_change(const double* f) {
+    int positive = 0, negative = 0;
+    for (int i = 0; i < 4; i++) {
+        if (f[i] >= 0) positive = 1;
+        if (f[i] <= 0) negative = 1;
+    }
+    return positive && negative;
+}
+
+// Quadtree over the view: boxes where interval evaluation proves either residual
+// nonzero are dropped, and leaf cells where both residuals change sign seed Newton
+static void search_intersections(IntersectionSearch* search, double x0, double x1, 
+                                 double y0, double y1, int depth) {
+    Interval x_range = {x0, x1}, y_range = {y0, y1};
+    Interval r1 = residual_interval(search->a, x_range, y_range, NULL);
+    if (r1.lo > 0 || r1.hi < 0) return;
+    Interval r2 = residual_interval(search->b, x_range, y_range, NULL);
+    if (r2.lo > 0 || r2.hi < 0) return;
+
+    if (depth < INTERSECT_DEPTH) {
+        double xm = (x0 + x1) / 2, ym = (y0 + y1) / 2;
+        search_intersections(search, x0, xm, y0, ym, depth + 1);
+        search_intersections(search, xm, x1, y0, ym, depth + 1);
+        search_intersections(search, x0, xm, ym, y1, depth + 1);
+        search_intersections(search, xm, x1, ym, y1, depth + 1);
+        return;
+    }
+
+    double f1[4] = {residual(search->a, x0, y0), residual(search->a, x1, y0), 
+                    residual(search->a, x0, y1), residual(search->a, x1, y1)};
+    if (!corner_sign_change(f1)) return;
+    double f2[4] = {residual(search->b, x0, y0), residual(search->b, x1, y0), 
+                    residual(search->b, x0, y1), residual(search->b, x1, y1)};
+    if (!corner_sign_change(f2)) return;
+
+    double x = (x0 + x1) / 2, y = (y0 + y1) / 2;
+    if (newton_intersection(search->a, search->b, &x, &y) != 0) return;
+
+    // Keep only roots near their seed cell so each is found from nearby, then merge duplicates
+    double w = x1 - x0, h = y1 - y0;
+    if (x < x0 - w || x > x1 + w || y < y0 - h || y > y1 + h) return;
+    for (int i = 0; i < search->count; i++) {
+        if (fabs(search->xs[i] - x) < search->tolerance && 
+            fabs(search->ys[i] - y) < search->tolerance) return;
+    }
+    if (search->count < search->max_points) {
+        search->xs[search->count] = x;
+        search->ys[search->count] = y;
+        search->count++;
+    }
+}
+
+// Find every intersection of two curves inside the current view; returns how many
+int find_intersections(const Equation* a, const Equation* b, PlotSettings settings, 
+                       double* xs, double* ys, int max_points) {
+    // Parametric and polar curves have no residual in x and y to intersect
+    if (a->kind != EQUATION_IMPLICIT || b->kind != EQUATION_IMPLICIT) return 0;
+    double half_width = GRID_WIDTH / 2 / (5.0 * settings.zoom);
+    double half_height = GRID_HEIGHT / 2 / (5.0 * settings.zoom);
+    IntersectionSearch search = {a, b, xs, ys, 0, max_points, 
+                                 2 * half_height / (1 << INTERSECT_DEPTH) * 1e-3};
+
+    search_intersections(&search, settings.x_offset - half_width, settings.x_offset + half_width, 
+                         settings.y_offset - half_height, settings.y_offset + half_height, 0);
+    return search.count;
+}
@@ -0,0 +1,229 @@
+// Parametric curves x = f(t), y = g(t) and polar curves r = f(theta): the expressions
+// are evaluated directly over a range of the parameter, refined where the traced
+// segments are long on screen
+#include "graphcalc_internal.h"
+
+// Read the parameter as the batch evaluator's x input; any other variable is undefined
+// here and is recorded in undefined
+static void bind_parameter(Token* tokens, int num_tokens, const char* parameter, char* undefined) {
+    mark_undefined(tokens, num_tokens, parameter, NULL, undefined);
+    for (int i = 0; i < num_tokens; i++) {
+        if (tokens[i].type == TOKEN_VARIABLE) strcpy(tokens[i].str, "x");
+    }
+}
+
+// Copy the name before the '=' of "name = value", without spaces, into name
+static char* split_definition(char* part, char* name, size_t size) {
+    char* equals = strchr(part, '=');
+    if (!equals) return NULL;
+    size_t length = 0;
+    for (char* c = part; c < equals; c++) {
+        if (!isspace((unsigned char)*c) && length + 1 < size) name[length++] = *c;
+    }
+    name[length] = '\0';
+    return equals + 1;
+}
+
+// Parse the traced forms "x = f(t), y = g(t)[, t = a..b]" and "r = f(theta)[, theta = a..b]"
+// from eq->text; the parameter runs over [0, 2*pi] unless given. Returns 0 when the text
+// is neither, leaving eq for the implicit parser.
+int parse_parametric(Equation* eq, const SymbolTable* symbols) {
+    char part[MAX_EQUATION_LENGTH], name[16];
+    strcpy(part, eq->text);
+    const char* first = split_definition(part, name, sizeof(name));
+    int defines_r = first && strcmp(name, "r") == 0;
+    int defines_x = first && strcmp(name, "x") == 0 && strchr(eq->text, ',');
+    if (!defines_r && !defines_x) return 0;
+
+    eq->kind = defines_r ? EQUATION_POLAR : EQUATION_PARAMETRIC;
+    eq->left_num_tokens = 0;
+    eq->right_num_tokens = 0;
+    eq->t_min = 0;
+    eq->t_max = 2 * PI;
+    const char* parameter = eq->kind == EQUATION_POLAR ? "theta" : "t";
+
+    const char* start = eq->text;
+    while (*start) {
+        const char* end = strchr(start, ',');
+        size_t length = end ? (size_t)(end - start) : strlen(start);
+        memcpy(part, start, length);
+        part[length] = '\0';
+        start += end ? length + 1 : length;
+
+        char* value = split_definition(part, name, sizeof(name));
+        if (!value) continue;
+        if (strcmp(name, eq->kind == EQUATION_POLAR ? "r" : "x") == 0) {
+            eq->left_num_tokens = tokenize_resolved(symbols, value, eq->left_tokens);
+        } else if (strcmp(name, "y") == 0 && eq->kind == EQUATION_PARAMETRIC) {
+            eq->right_num_tokens = tokenize_resolved(symbols, value, eq->right_tokens);
+        } else if (strcmp(name, parameter) == 0) {
+            char* dots = strstr(value, "..");
+            if (!dots) continue;
+            *dots = '\0';
+            double t_min = evaluate_constant(value), t_max = evaluate_constant(dots + 2);
+            if (isfinite(t_min) && isfinite(t_max) && t_min < t_max) {
+                eq->t_min = t_min;
+                eq->t_max = t_max;
+            }
+        }
+    }
+
+    bind_parameter(eq->left_tokens, eq->left_num_tokens, parameter, eq->undefined);
+    bind_parameter(eq->right_tokens, eq->right_num_tokens, parameter, eq->undefined);
+    compile_program(eq->left_tokens, eq->left_num_tokens, &eq->curve_x);
+    compile_program(eq->right_tokens, eq->right_num_tokens, &eq->curve_y);
+
+    // Nothing is root-found, so the implicit samplers see no residual
+    eq->residual.length = -1;
+    memset(&eq->analysis, 0, sizeof(eq->analysis));
+    eq->analysis.shape = SHAPE_GENERAL;
+    return 1;
+}
+
+// Evaluate both coordinates at n parameter values, batched when the expressions
+// compiled. Polar curves evaluate r(theta) into x and convert.
+static void eval_curve(const Equation* eq, const double* t, double* x, double* y, int n) {
+    if (eq->curve_x.length >= 0) {
+        program_eval_batch(&eq->curve_x, t, t, x, n);
+    } else {
+        for (int i = 0; i < n; i++) {
+            x[i] = evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, t[i], 0);
+        }
+    }
+    if (eq->kind == EQUATION_POLAR) {
+        for (int i = 0; i < n; i++) {
+            double r = x[i];
+            x[i] = r * cos(t[i]);
+            y[i] = r * sin(t[i]);
+        }
+    } else if (eq->curve_y.length >= 0) {
+        program_eval_batch(&eq->curve_y, t, t, y, n);
+    } else {
+        for (int i = 0; i < n; i++) {
+            y[i] = evaluate_expression((Token*)eq->right_tokens, eq->right_num_tokens, t[i], 0);
+        }
+    }
+}
+
+// Whether the segment from point a to point b, in cells from the view's centre, needs a
+// midpoint: it is longer than a cell and may cross the view, or it runs into a pole or a
+// gap in the domain near the view
+static int segment_needs_split(double ax, double ay, double bx, double by) {
+    double half_w = GRID_WIDTH / 2 + 1, half_h = GRID_HEIGHT / 2 + 1;
+    int a_finite = isfinite(ax) && isfinite(ay), b_finite = isfinite(bx) && isfinite(by);
+    if (a_finite != b_finite) {
+        double x = a_finite ? ax : bx, y = a_finite ? ay : by;
+        return fabs(x) <= half_w && fabs(y) <= half_h;
+    }
+    if (!a_finite) return 0;
+    if (fabs(bx - ax) <= 1 && fabs(by - ay) <= 1) return 0;
+    return fmax(ax, bx) >= -half_w && fmin(ax, bx) <= half_w && 
+           fmax(ay, by) >= -half_h && fmin(ay, by) <= half_h;
+}
+
+// Trace eq over its parameter range into trace, in view units. Starts from
+// PARAM_INITIAL_SAMPLES uniform steps and inserts midpoints level by level, each
+// level evaluated in one batch, until every segment near the view spans at most a cell.
+int trace_parametric(Context* ctx, const Equation* eq, PlotSettings settings, CurveTrace* trace) {
+    double scale = 5.0 * settings.zoom;
+    int count = PARAM_INITIAL_SAMPLES + 1;
+    double* t = malloc(count * sizeof(double));
+    double* x = malloc(count * sizeof(double));
+    double* y = malloc(count * sizeof(double));
+    trace->x = trace->y = NULL;
+    trace->count = 0;
+    if (!t || !x || !y) {
+        free(t);
+        free(x);
+        free(y);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        t[i] = eq->t_min + (eq->t_max - eq->t_min) * i / PARAM_INITIAL_SAMPLES;
+    }
+    eval_curve(eq, t, x, y, count);
+
+    int status = 0;
+    for (int depth = 0; depth < PARAM_MAX_DEPTH; depth++) {
+        // Mark the segments to split, stopping short of the point budget
+        unsigned char* split = malloc(count - 1);
+        if (!split) {
+            status = -1;
+            break;
+        }
+        int num_new = 0;
+        for (int i = 0; i + 1 < count; i++) {
+            split[i] = count + num_new < PARAM_MAX_POINTS && 
+                       segment_needs_split((x[i] - settings.x_offset) * scale, 
+                                           (y[i] - settings.y_offset) * scale, 
+                                           (x[i + 1] - settings.x_offset) * scale, 
+                                           (y[i + 1] - settings.y_offset) * scale);
+            num_new += split[i];
+        }
+        if (num_new == 0) {
+            free(split);
+            break;
+        }
+
+        // Evaluate every new midpoint in one pass, then interleave them
+        int merged = count + num_new;
+        double* mid = malloc(3 * num_new * sizeof(double));
+        double* new_t = malloc(merged * sizeof(double));
+        double* new_x = malloc(merged * sizeof(double));
+        double* new_y = malloc(merged * sizeof(double));
+        if (!mid || !new_t || !new_x || !new_y) {
+            free(split);
+            free(mid);
+            free(new_t);
+            free(new_x);
+            free(new_y);
+            status = -1;
+            break;
+        }
+        double *mid_t = mid, *mid_x = mid + num_new, *mid_y = mid + 2 * num_new;
+        for (int i = 0, m = 0; i + 1 < count; i++) {
+            if (split[i]) mid_t[m++] = 0.5 * (t[i] + t[i + 1]);
+        }
+        eval_curve(eq, mid_t, mid_x, mid_y, num_new);
+
+        for (int i = 0, m = 0, out = 0; i < count; i++) {
+            new_t[out] = t[i];
+            new_x[out] = x[i];
+            new_y[out++] = y[i];
+            if (i + 1 < count && split[i]) {
+                new_t[out] = mid_t[m];
+                new_x[out] = mid_x[m];
+                new_y[out++] = mid_y[m++];
+            }
+        }
+        free(split);
+        free(mid);
+        free(t);
+        free(x);
+        free(y);
+        t = new_t;
+        x = new_x;
+        y = new_y;
+        count = merged;
+    }
+
+    free(t);
+    if (status != 0) {
+        free(x);
+        free(y);
+        return -1;
+    }
+    trace->x = x;
+    trace->y = y;
+    trace->count = count;
+    STATS_ADD(ctx, parametric_points, count);
+    return 0;
+}
+
+void free_curve_trace(CurveTrace* trace) {
+    free(trace->x);
+    free(trace->y);
+    trace->x = trace->y = NULL;
+    trace->count = 0;
+}
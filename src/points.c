@@ -0,0 +1,116 @@
+// Raw root export as CSV or packed little-endian binary
+#include "graphcalc_internal.h"
+
+static void store_le32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void store_le64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void store_le_double(unsigned char* p, double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    store_le64(p, bits);
+}
+
+// Binary header: "GCPT", version, header size, doubles per record, point count (all
+// little-endian). The count is patched once the stream ends, or left as UINT64_MAX if
+// the output can't seek.
+static void fill_points_header(unsigned char* header, uint64_t num_points) {
+    memcpy(header, POINTS_MAGIC, 4);
+    store_le32(header + 4, POINTS_VERSION);
+    store_le32(header + 8, POINTS_HEADER_SIZE);
+    store_le32(header + 12, POINTS_RECORD_FIELDS);
+    store_le64(header + 16, num_points);
+    memset(header + 24, 0, POINTS_HEADER_SIZE - 24);
+}
+
+// Export every distinct root at num_samples evenly spaced x values across the view,
+// as "curve,x,y" CSV rows or as packed little-endian (x, y, curve) doubles after a
+// fixed header. Samples are solved in parallel blocks of POINTS_BLOCK_SIZE and each
+// block is written as soon as it completes, in x order.
+int export_points(const Equation* const* eqs, int num_equations, PlotSettings settings, 
+                  const char* filename, int num_samples, int binary) {
+    if (num_samples <= 0) return -1;
+
+    FILE* out = fopen(filename, binary ? "wb" : "w");
+    if (!out) return -1;
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+    double x_start = settings.x_offset - GRID_WIDTH / 2 / (5.0 * settings.zoom);
+    double x_step = GRID_WIDTH / (5.0 * settings.zoom) / num_samples;
+
+    size_t stride = (size_t)num_equations * NUM_INITIAL_GUESSES;
+    size_t record_size = POINTS_RECORD_FIELDS * sizeof(double);
+    double* block_roots = malloc(POINTS_BLOCK_SIZE * stride * sizeof(double));
+    int* block_counts = malloc(POINTS_BLOCK_SIZE * num_equations * sizeof(int));
+    unsigned char* records = malloc(POINTS_BLOCK_SIZE * stride * record_size);
+    if (!block_roots || !block_counts || !records) {
+        free(block_roots);
+        free(block_counts);
+        free(records);
+        fclose(out);
+        return -1;
+    }
+
+    unsigned char header[POINTS_HEADER_SIZE];
+    if (binary) {
+        fill_points_header(header, UINT64_MAX);
+        fwrite(header, 1, sizeof(header), out);
+    } else {
+        fprintf(out, "curve,x,y\n");
+    }
+
+    uint64_t num_points = 0;
+    int status = 0;
+    for (int first = 0; first < num_samples && status == 0; first += POINTS_BLOCK_SIZE) {
+        int block = num_samples - first < POINTS_BLOCK_SIZE ? num_samples - first : POINTS_BLOCK_SIZE;
+
+        #pragma omp parallel for schedule(dynamic, 8)
+        for (int s = 0; s < block; s++) {
+            double roots[MAX_EQUATIONS * NUM_INITIAL_GUESSES];
+            double x_val = x_start + (first + s) * x_step;
+            sample_all_roots(NULL, eqs, num_equations, x_val, roots);
+            for (int e = 0; e < num_equations; e++) {
+                block_counts[s * num_equations + e] = 
+                    collect_distinct_roots(roots + e * NUM_INITIAL_GUESSES, NUM_INITIAL_GUESSES, 
+                                           ROOT_TOLERANCE, block_roots + s * stride + e * NUM_INITIAL_GUESSES);
+            }
+        }
+
+        size_t bytes = 0;
+        for (int s = 0; s < block; s++) {
+            double x_val = x_start + (first + s) * x_step;
+            for (int e = 0; e < num_equations; e++) {
+                const double* ys = block_roots + s * stride + e * NUM_INITIAL_GUESSES;
+                int count = block_counts[s * num_equations + e];
+                for (int r = 0; r < count; r++) {
+                    if (binary) {
+                        store_le_double(records + bytes, x_val);
+                        store_le_double(records + bytes + 8, ys[r]);
+                        store_le_double(records + bytes + 16, (double)e);
+                        bytes += record_size;
+                    } else if (fprintf(out, "%d,%.17g,%.17g\n", e, x_val, ys[r]) < 0) {
+                        status = -1;
+                    }
+                }
+                num_points += count;
+            }
+        }
+        if (binary && fwrite(records, 1, bytes, out) != bytes) status = -1;
+    }
+
+    // Patch the real count into the header when the output is a regular file
+    if (binary && status == 0 && fseek(out, 0, SEEK_SET) == 0) {
+        fill_points_header(header, num_points);
+        if (fwrite(header, 1, sizeof(header), out) != sizeof(header)) status = -1;
+    }
+
+    free(block_roots);
+    free(block_counts);
+    free(records);
+    if (fclose(out) != 0) status = -1;
+    return status;
+}
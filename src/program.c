@@ -0,0 +1,281 @@
+// Bytecode compiler for equation residuals and the batch evaluator, built in double
+// and float for each instruction set and dispatched at first use
+#include "graphcalc_internal.h"
+
+typedef struct {
+    Program* program;
+    int depth;
+    int max_depth;
+} Compiler;
+
+static void emit_instruction(Compiler* c, Instruction ins) {
+    if (c->program->length >= PROGRAM_MAX_LENGTH) {
+        c->max_depth = INT_MAX;  // Cannot happen for tokenizer output; fail safe anyway
+        return;
+    }
+    c->program->code[c->program->length++] = ins;
+    OpCode op = ins.op;
+    if (op == OP_CONST || op == OP_X || op == OP_Y || op == OP_PARAM) {
+        if (++c->depth > c->max_depth) c->max_depth = c->depth;
+    } else if (op < OP_SIN) {
+        c->depth--;
+    }
+}
+
+static void emit(Compiler* c, OpCode op, double value) {
+    emit_instruction(c, (Instruction){op, value, NULL});
+}
+
+// Emit code for a token range, mirroring evaluate_expression case for case
+static void compile_expression(Compiler* c, const Token* tokens, int num_tokens) {
+    if (num_tokens <= 0) {
+        emit(c, OP_CONST, 0);
+        return;
+    }
+
+    if (num_tokens == 1) {
+        const Token* token = &tokens[0];
+        if (token->type == TOKEN_NUMBER) emit(c, OP_CONST, token->value);
+        else if (token->type == TOKEN_PARAMETER) emit_instruction(c, (Instruction){OP_PARAM, 0, token->slot});
+        else if (token->type == TOKEN_VARIABLE && strcmp(token->str, "x") == 0) emit(c, OP_X, 0);
+        else if (token->type == TOKEN_VARIABLE && strcmp(token->str, "y") == 0) emit(c, OP_Y, 0);
+        else emit(c, OP_CONST, 0);
+        return;
+    }
+
+    int split = -1;
+    int min_prec = 999;
+    int paren_depth = 0;
+    for (int i = num_tokens - 1; i >= 0; i--) {
+        if (tokens[i].type == TOKEN_RPAREN) paren_depth++;
+        else if (tokens[i].type == TOKEN_LPAREN) paren_depth--;
+        else if (paren_depth == 0 && tokens[i].type == TOKEN_OPERATOR) {
+            int prec = get_precedence(tokens[i].str[0]);
+            if (prec <= min_prec) {
+                min_prec = prec;
+                split = i;
+            }
+        }
+    }
+
+    if (split == -1) {
+        if (tokens[0].type == TOKEN_FUNCTION) {
+            static const struct { const char* name; OpCode op; } functions[] = {
+                {"sin", OP_SIN}, {"cos", OP_COS}, {"tan", OP_TAN}, 
+                {"log", OP_LOG10}, {"ln", OP_LN}, {"exp", OP_EXP}, {"atan", OP_ATAN}
+            };
+            for (size_t f = 0; f < sizeof(functions) / sizeof(functions[0]); f++) {
+                if (strcmp(tokens[0].str, functions[f].name) == 0) {
+                    compile_expression(c, tokens + 2, num_tokens - 3);
+                    emit(c, functions[f].op, 0);
+                    return;
+                }
+            }
+        }
+        if (tokens[0].type == TOKEN_LPAREN && tokens[num_tokens - 1].type == TOKEN_RPAREN) {
+            compile_expression(c, tokens + 1, num_tokens - 2);
+            return;
+        }
+        emit(c, OP_CONST, 0);
+        return;
+    }
+
+    compile_expression(c, tokens, split);
+    compile_expression(c, tokens + split + 1, num_tokens - split - 1);
+    switch (tokens[split].str[0]) {
+        case '+': emit(c, OP_ADD, 0); break;
+        case '-': emit(c, OP_SUB, 0); break;
+        case '*': emit(c, OP_MUL, 0); break;
+        case '/': emit(c, OP_DIV, 0); break;
+        default: emit(c, OP_POW, 0); break;  // '^'; the tokenizer emits no other operators
+    }
+}
+
+// Compile left - right into one program
+void compile_residual(const Equation* eq, Program* program) {
+    Compiler c = {program, 0, 0};
+    program->length = 0;
+    compile_expression(&c, eq->left_tokens, eq->left_num_tokens);
+    compile_expression(&c, eq->right_tokens, eq->right_num_tokens);
+    emit(&c, OP_SUB, 0);
+    if (c.max_depth > PROGRAM_MAX_STACK) program->length = -1;
+}
+
+// Compile a single expression, as used for each half of a parametric curve
+void compile_program(const Token* tokens, int num_tokens, Program* program) {
+    Compiler c = {program, 0, 0};
+    program->length = 0;
+    compile_expression(&c, tokens, num_tokens);
+    if (c.max_depth > PROGRAM_MAX_STACK) program->length = -1;
+}
+
+typedef void (*ProgramKernel)(const Program* program, const double* x, const double* y, 
+                              double* out, double* scale, int num_lanes);
+typedef void (*ProgramKernelFloat)(const Program* program, const float* x, const float* y, 
+                                   float* out, float* scale, int num_lanes);
+
+// Double and float kernels for the baseline, built with the library's own flags
+#define PROGRAM_REAL double
+#define PROGRAM_MATH(fn) fn
+#define PROGRAM_KERNEL program_kernel_default
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+
+#define PROGRAM_REAL float
+#define PROGRAM_MATH(fn) fn##f
+#define PROGRAM_KERNEL program_kernel_float_default
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PROGRAM_HAS_ISA_VARIANTS
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+#define PROGRAM_REAL double
+#define PROGRAM_MATH(fn) fn
+#define PROGRAM_KERNEL program_kernel_sse42
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+#define PROGRAM_REAL float
+#define PROGRAM_MATH(fn) fn##f
+#define PROGRAM_KERNEL program_kernel_float_sse42
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define PROGRAM_REAL double
+#define PROGRAM_MATH(fn) fn
+#define PROGRAM_KERNEL program_kernel_avx2
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+#define PROGRAM_REAL float
+#define PROGRAM_MATH(fn) fn##f
+#define PROGRAM_KERNEL program_kernel_float_avx2
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,prefer-vector-width=512")
+#define PROGRAM_REAL double
+#define PROGRAM_MATH(fn) fn
+#define PROGRAM_KERNEL program_kernel_avx512
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+#define PROGRAM_REAL float
+#define PROGRAM_MATH(fn) fn##f
+#define PROGRAM_KERNEL program_kernel_float_avx512
+#include "program_kernel.h"
+#undef PROGRAM_KERNEL
+#undef PROGRAM_REAL
+#undef PROGRAM_MATH
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    const char* name;
+    ProgramKernel kernel;
+    ProgramKernelFloat kernel_float;
+    const char* cpu_feature;  // __builtin_cpu_supports name; NULL runs everywhere
+} KernelVariant;
+
+// Best first
+static const KernelVariant kernel_variants[] = {
+#ifdef PROGRAM_HAS_ISA_VARIANTS
+    {"avx512f", program_kernel_avx512, program_kernel_float_avx512, "avx512f"},
+    {"avx2", program_kernel_avx2, program_kernel_float_avx2, "avx2"},
+    {"sse4.2", program_kernel_sse42, program_kernel_float_sse42, "sse4.2"},
+#endif
+    {"default", program_kernel_default, program_kernel_float_default, NULL}
+};
+#define NUM_KERNEL_VARIANTS ((int)(sizeof(kernel_variants) / sizeof(kernel_variants[0])))
+
+static int variant_supported(const KernelVariant* variant) {
+    if (!variant->cpu_feature) return 1;
+#ifdef PROGRAM_HAS_ISA_VARIANTS
+    // __builtin_cpu_supports only accepts string literals
+    if (strcmp(variant->cpu_feature, "avx512f") == 0) return __builtin_cpu_supports("avx512f");
+    if (strcmp(variant->cpu_feature, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if (strcmp(variant->cpu_feature, "sse4.2") == 0) return __builtin_cpu_supports("sse4.2");
+#endif
+    return 0;
+}
+
+// Pick the variant once: GRAPHCALC_ISA if the CPU can run it, else the best supported.
+// Racing first calls all store the same answer, so relaxed atomics are enough.
+static const KernelVariant* selected_variant(void) {
+    static const KernelVariant* selected;
+    const KernelVariant* variant = __atomic_load_n(&selected, __ATOMIC_RELAXED);
+    if (variant) return variant;
+
+#ifdef PROGRAM_HAS_ISA_VARIANTS
+    __builtin_cpu_init();
+#endif
+    const char* forced = getenv("GRAPHCALC_ISA");
+    for (int v = 0; forced && v < NUM_KERNEL_VARIANTS; v++) {
+        if (strcmp(forced, kernel_variants[v].name) == 0 && variant_supported(&kernel_variants[v])) {
+            variant = &kernel_variants[v];
+        }
+    }
+    for (int v = 0; !variant && v < NUM_KERNEL_VARIANTS; v++) {
+        if (variant_supported(&kernel_variants[v])) variant = &kernel_variants[v];
+    }
+    __atomic_store_n(&selected, variant, __ATOMIC_RELAXED);
+    return variant;
+}
+
+const char* program_isa(void) {
+    return selected_variant()->name;
+}
+
+// Evaluate a compiled residual at n points, BATCH_LANES at a time
+void program_eval_batch(const Program* program, const double* x, const double* y, 
+                        double* out, int n) {
+    ProgramKernel kernel = selected_variant()->kernel;
+    for (int start = 0; start < n; start += BATCH_LANES) {
+        int lanes = n - start < BATCH_LANES ? n - start : BATCH_LANES;
+        if (lanes == BATCH_LANES) {
+            kernel(program, x + start, y + start, out + start, NULL, lanes);
+            continue;
+        }
+        // Pad the last partial batch so the kernel always reads full lanes
+        double x_pad[BATCH_LANES] = {0}, y_pad[BATCH_LANES] = {0};
+        memcpy(x_pad, x + start, lanes * sizeof(double));
+        memcpy(y_pad, y + start, lanes * sizeof(double));
+        kernel(program, x_pad, y_pad, out + start, NULL, lanes);
+    }
+}
+
+// Single-precision program_eval_batch; scale receives each point's cancellation scale
+void program_eval_batch_float(const Program* program, const float* x, const float* y, 
+                              float* out, float* scale, int n) {
+    ProgramKernelFloat kernel = selected_variant()->kernel_float;
+    for (int start = 0; start < n; start += BATCH_LANES) {
+        int lanes = n - start < BATCH_LANES ? n - start : BATCH_LANES;
+        if (lanes == BATCH_LANES) {
+            kernel(program, x + start, y + start, out + start, scale + start, lanes);
+            continue;
+        }
+        float x_pad[BATCH_LANES] = {0}, y_pad[BATCH_LANES] = {0};
+        memcpy(x_pad, x + start, lanes * sizeof(float));
+        memcpy(y_pad, y + start, lanes * sizeof(float));
+        kernel(program, x_pad, y_pad, out + start, scale + start, lanes);
+    }
+}
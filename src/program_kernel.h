@@ -0,0 +1,75 @@
+// Batch stack-machine kernel, included by program.c once per instruction set and
+// element type. PROGRAM_KERNEL names the variant, PROGRAM_REAL is double or float
+// and PROGRAM_MATH(fn) picks the matching libm function. Runs one program over
+// BATCH_LANES points; lanes past num_lanes hold padding and are skipped by the
+// scalar libm calls. Arithmetic is one operation per loop, so the double variants
+// match evaluate_expression bit for bit.
+//
+// When scale is non-NULL it receives, per lane, the largest operand magnitude seen
+// by any addition or subtraction: rounding noise in the result is about
+// epsilon * scale, which is how callers detect cancellation.
+static void PROGRAM_KERNEL(const Program* program, const PROGRAM_REAL* x, const PROGRAM_REAL* y, 
+                           PROGRAM_REAL* out, PROGRAM_REAL* scale, int num_lanes) {
+    PROGRAM_REAL stack[PROGRAM_MAX_STACK][BATCH_LANES];
+    PROGRAM_REAL magnitude[BATCH_LANES] = {0};
+    int top = -1;
+
+    for (int pc = 0; pc < program->length; pc++) {
+        const Instruction* ins = &program->code[pc];
+        OpCode op = ins->op;
+
+        if (op == OP_CONST || op == OP_X || op == OP_Y || op == OP_PARAM) {
+            PROGRAM_REAL* restrict dst = stack[++top];
+            if (op == OP_CONST || op == OP_PARAM) {
+                // A parameter is read once per batch, so a new value needs no recompile
+                PROGRAM_REAL value = (PROGRAM_REAL)(op == OP_PARAM ? *ins->slot : ins->value);
+                for (int i = 0; i < BATCH_LANES; i++) dst[i] = value;
+            } else {
+                memcpy(dst, op == OP_X ? x : y, sizeof(stack[0]));
+            }
+            continue;
+        }
+
+        if (op >= OP_SIN) {
+            PROGRAM_REAL* restrict a = stack[top];
+            switch (op) {
+                case OP_SIN: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(sin)(a[i]); break;
+                case OP_COS: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(cos)(a[i]); break;
+                case OP_TAN: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(tan)(a[i]); break;
+                case OP_LOG10: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(log10)(a[i]); break;
+                case OP_LN: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(log)(a[i]); break;
+                case OP_EXP: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(exp)(a[i]); break;
+                case OP_ATAN: for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(atan)(a[i]); break;
+                default: break;
+            }
+            continue;
+        }
+
+        PROGRAM_REAL* restrict a = stack[top - 1];
+        const PROGRAM_REAL* restrict b = stack[top];
+        top--;
+        if (scale && (op == OP_ADD || op == OP_SUB)) {
+            for (int i = 0; i < BATCH_LANES; i++) {
+                PROGRAM_REAL fa = PROGRAM_MATH(fabs)(a[i]), fb = PROGRAM_MATH(fabs)(b[i]);
+                PROGRAM_REAL m = fa > fb ? fa : fb;
+                magnitude[i] = magnitude[i] > m ? magnitude[i] : m;
+            }
+        }
+        switch (op) {
+            case OP_ADD: for (int i = 0; i < BATCH_LANES; i++) a[i] = a[i] + b[i]; break;
+            case OP_SUB: for (int i = 0; i < BATCH_LANES; i++) a[i] = a[i] - b[i]; break;
+            case OP_MUL: for (int i = 0; i < BATCH_LANES; i++) a[i] = a[i] * b[i]; break;
+            case OP_DIV: 
+                // Divide everywhere, then patch zero divisors, so both loops vectorize
+                for (int i = 0; i < BATCH_LANES; i++) a[i] = a[i] / b[i];
+                for (int i = 0; i < BATCH_LANES; i++) a[i] = b[i] == 0 ? INFINITY : a[i];
+                break;
+            case OP_POW: 
+                for (int i = 0; i < num_lanes; i++) a[i] = PROGRAM_MATH(pow)(a[i], b[i]); 
+                break;
+            default: break;
+        }
+    }
+    memcpy(out, stack[0], num_lanes * sizeof(PROGRAM_REAL));
+    if (scale) memcpy(scale, magnitude, num_lanes * sizeof(PROGRAM_REAL));
+}
@@ -0,0 +1,249 @@
+// Banded PGM/PPM raster export
+#include "graphcalc_internal.h"
+
+// Band of image rows rasterized into a bounded buffer
+typedef struct {
+    unsigned char* pixels;
+    int width;
+    int channels;
+    int row_start;
+    int row_end;
+    const unsigned char* color;
+} RasterBand;
+
+static void plot_band_pixel(void* target, int x, int y) {
+    RasterBand* band = target;
+    if (y >= band->row_start && y < band->row_end && x >= 0 && x < band->width) {
+        unsigned char* p = band->pixels + 
+                           ((size_t)(y - band->row_start) * band->width + x) * band->channels;
+        memcpy(p, band->color, band->channels);
+    }
+}
+
+// Map a root to an image row, clamped just outside the image so joins still reach the edge
+static int raster_row(double y_val, double y_offset, double units_per_px, int height) {
+    if (isnan(y_val) || isinf(y_val)) return INT_MIN;
+    double row = floor(height / 2.0 - (y_val - y_offset) / units_per_px);
+    if (row < -1) return -1;
+    if (row > height) return height;
+    return (int)row;
+}
+
+// Tint the band's pixels inside an inequality's region a quarter of the way from the
+// background to the curve colour; mask has room for one band
+static int shade_band(RasterBand* band, const Equation* eq, double x_min, double y_max, 
+                      double units_per_px, const unsigned char* palette, 
+                      const unsigned char* color, unsigned char* mask) {
+    int band_rows = band->row_end - band->row_start;
+    if (shade_region(NULL, eq, x_min, y_max - band->row_start * units_per_px, units_per_px, 
+                     band->width, band_rows, mask) != 0) {
+        return -1;
+    }
+
+    unsigned char tint[3];
+    for (int ch = 0; ch < band->channels; ch++) tint[ch] = (3 * palette[ch] + color[ch]) / 4;
+    for (size_t p = 0; p < (size_t)band_rows * band->width; p++) {
+        if (mask[p]) memcpy(band->pixels + p * band->channels, tint, band->channels);
+    }
+    return 0;
+}
+
+// Fill one band: background, inequality regions, axes, then every curve segment that
+// crosses it. rows holds num_curves * NUM_INITIAL_GUESSES entries per pixel column, and
+// joins whether each entry continues the same guess in the previous column.
+static int rasterize_band(RasterBand* band, const int* rows, const unsigned char* joins, 
+                          const Equation* const* eqs, int num_curves, int height, int axis_x, 
+                          int axis_y, double x_min, double y_max, double units_per_px, 
+                          const unsigned char* palette, const unsigned char* curve_colors, 
+                          unsigned char* mask) {
+    int width = band->width;
+    int channels = band->channels;
+    int stride = num_curves * NUM_INITIAL_GUESSES;
+    size_t band_pixels = (size_t)(band->row_end - band->row_start) * width;
+
+    // palette[0] background, palette[1] axes
+    for (size_t p = 0; p < band_pixels; p++) {
+        memcpy(band->pixels + p * channels, palette, channels);
+    }
+    for (int e = 0; e < num_curves; e++) {
+        if (eqs[e]->kind != EQUATION_IMPLICIT || eqs[e]->relation == RELATION_EQUAL) continue;
+        if (shade_band(band, eqs[e], x_min, y_max, units_per_px, palette, 
+                       curve_colors + e * channels, mask) != 0) {
+            return -1;
+        }
+    }
+
+    band->color = palette + channels;
+    if (axis_y >= band->row_start && axis_y < band->row_end) {
+        draw_line(0, axis_y, width - 1, axis_y, plot_band_pixel, band);
+    }
+    if (axis_x >= 0 && axis_x < width) {
+        draw_line(axis_x, band->row_start, axis_x, band->row_end - 1, plot_band_pixel, band);
+    }
+
+    for (int e = 0; e < num_curves; e++) {
+        band->color = curve_colors + e * channels;
+
+        for (int c = 0; c < width; c++) {
+            const int* col = rows + (size_t)c * stride + e * NUM_INITIAL_GUESSES;
+            const int* prev = c > 0 ? col - stride : NULL;
+            const unsigned char* joined = joins + (size_t)c * stride + e * NUM_INITIAL_GUESSES;
+
+            for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+                int row = col[k];
+                if (row == INT_MIN) continue;
+
+                // Join to the same guess in the previous column, skipping segments
+                // that lie entirely outside this band
+                if (prev && prev[k] != INT_MIN && joined[k]) {
+                    int lo = row < prev[k] ? row : prev[k];
+                    int hi = row < prev[k] ? prev[k] : row;
+                    if (hi >= band->row_start && lo < band->row_end) {
+                        draw_line(c - 1, prev[k], c, row, plot_band_pixel, band);
+                    }
+                } else if (row >= 0 && row < height) {
+                    plot_band_pixel(band, c, row);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Export the current view as a binary PGM (channels = 1) or PPM (channels = 3) image.
+// Roots are sampled once per pixel column, then the image is rasterized in bands of
+// RASTER_BAND_HEIGHT rows so memory stays proportional to the width, not the area.
+int export_raster(const Equation* const* eqs, int num_equations, PlotSettings settings, 
+                  const char* filename, int width, int height, int channels) {
+    static const unsigned char gray_palette[] = {255, 160};
+    static const unsigned char color_palette[] = {255, 255, 255, 160, 160, 160};
+    const unsigned char* palette = channels == 1 ? gray_palette : color_palette;
+
+    if (width <= 0 || height <= 0 || (channels != 1 && channels != 3)) return -1;
+
+    // Curves are black in PGM and take the shared curve colours in PPM
+    unsigned char curve_colors[MAX_EQUATIONS * 3];
+    for (int e = 0; e < num_equations; e++) {
+        if (channels == 1) curve_colors[e] = 0;
+        else memcpy(curve_colors + e * 3, RGB_CURVE_COLORS[e % NUM_CURVE_COLORS], 3);
+    }
+
+    FILE* out = fopen(filename, "wb");
+    if (!out) return -1;
+
+    // Same viewport as the character grid, with square pixels; far-off axes are parked
+    // outside the image, as in render_pass
+    double units_per_px = GRID_WIDTH / (5.0 * settings.zoom) / width;
+    double axis_px = floor(width / 2.0 - settings.x_offset / units_per_px);
+    double axis_py = floor(height / 2.0 + settings.y_offset / units_per_px);
+    int axis_x = fabs(axis_px) < width * 2.0 ? (int)axis_px : -1;
+    int axis_y = fabs(axis_py) < height * 2.0 ? (int)axis_py : -1;
+    double x_min = settings.x_offset - width / 2.0 * units_per_px;
+    double y_max = settings.y_offset + height / 2.0 * units_per_px;
+
+    size_t stride = (size_t)num_equations * NUM_INITIAL_GUESSES;
+    int* rows = malloc(width * stride * sizeof(int));
+    double* roots = malloc(width * stride * sizeof(double));
+    unsigned char* joins = malloc(width * stride);
+    if (!rows || !roots || !joins) {
+        free(rows);
+        free(roots);
+        free(joins);
+        fclose(out);
+        return -1;
+    }
+
+    // Sample every pixel column in parallel
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int c = 0; c < width; c++) {
+        double x_val = settings.x_offset + (c + 0.5 - width / 2.0) * units_per_px;
+        sample_all_roots(NULL, eqs, num_equations, x_val, roots + c * stride);
+        for (size_t k = 0; k < stride; k++) {
+            rows[c * stride + k] = raster_row(roots[c * stride + k], settings.y_offset, 
+                                              units_per_px, height);
+        }
+    }
+
+    // Decide which guesses join across each pair of columns; steps of more than a
+    // pixel are checked so poles and gaps between branches stay open
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int c = 0; c < width; c++) {
+        double x_val = settings.x_offset + (c + 0.5 - width / 2.0) * units_per_px;
+        for (int e = 0; e < num_equations; e++) {
+            JoinCache cache;
+            cache.count = 0;
+            for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+                size_t i = c * stride + e * NUM_INITIAL_GUESSES + k;
+                joins[i] = c > 0 && rows[i] != INT_MIN && rows[i - stride] != INT_MIN && 
+                           (abs(rows[i] - rows[i - stride]) <= 1 || 
+                            join_cache_connected(&cache, NULL, eqs[e], x_val - units_per_px, 
+                                                 roots[i - stride], x_val, roots[i], units_per_px));
+            }
+        }
+    }
+    free(roots);
+
+    // One band buffer per worker; each group of bands is rasterized in parallel
+    // and written in order before the buffers are reused
+    int num_workers = 1;
+#ifdef _OPENMP
+    num_workers = omp_get_max_threads();
+#endif
+    size_t band_bytes = (size_t)RASTER_BAND_HEIGHT * width * channels;
+    size_t mask_bytes = (size_t)RASTER_BAND_HEIGHT * width;
+    unsigned char* buffers = malloc(band_bytes * num_workers);
+    unsigned char* masks = malloc(mask_bytes * num_workers);
+    if (!buffers || !masks) {
+        free(buffers);
+        free(masks);
+        free(rows);
+        free(joins);
+        fclose(out);
+        return -1;
+    }
+
+    fprintf(out, "P%d\n%d %d\n255\n", channels == 1 ? 5 : 6, width, height);
+
+    int num_bands = (height + RASTER_BAND_HEIGHT - 1) / RASTER_BAND_HEIGHT;
+    int status = 0;
+    for (int first = 0; first < num_bands && status == 0; first += num_workers) {
+        int group = num_bands - first < num_workers ? num_bands - first : num_workers;
+
+        int failed = 0;
+        #pragma omp parallel for schedule(static, 1) reduction(|:failed)
+        for (int b = 0; b < group; b++) {
+            RasterBand band;
+            band.pixels = buffers + band_bytes * b;
+            band.width = width;
+            band.channels = channels;
+            band.row_start = (first + b) * RASTER_BAND_HEIGHT;
+            band.row_end = band.row_start + RASTER_BAND_HEIGHT < height ? 
+                           band.row_start + RASTER_BAND_HEIGHT : height;
+            failed |= rasterize_band(&band, rows, joins, eqs, num_equations, height, axis_x, 
+                                     axis_y, x_min, y_max, units_per_px, palette, curve_colors, 
+                                     masks + mask_bytes * b) != 0;
+        }
+        if (failed) {
+            status = -1;
+            break;
+        }
+
+        for (int b = 0; b < group; b++) {
+            int row_start = (first + b) * RASTER_BAND_HEIGHT;
+            int band_rows = height - row_start < RASTER_BAND_HEIGHT ? 
+                            height - row_start : RASTER_BAND_HEIGHT;
+            size_t bytes = (size_t)band_rows * width * channels;
+            if (fwrite(buffers + band_bytes * b, 1, bytes, out) != bytes) {
+                status = -1;
+                break;
+            }
+        }
+    }
+
+    free(buffers);
+    free(masks);
+    free(rows);
+    free(joins);
+    if (fclose(out) != 0) status = -1;
+    return status;
+}
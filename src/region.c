@@ -0,0 +1,119 @@
+// Inequality shading: a quadtree over the cells proves whole tiles inside or outside
+// the region with interval bounds, so only tiles on the boundary are evaluated per cell
+#include "graphcalc_internal.h"
+
+typedef struct {
+    Context* ctx;
+    const Equation* eq;
+    double x_min;
+    double y_max;
+    double cell;
+    int width;
+    unsigned char* mask;
+    int* pending;  // Cells left for point evaluation, as row * width + column
+    int num_pending;
+} RegionSearch;
+
+// Whether a residual value satisfies the relation; NaN never does
+int relation_holds(Relation relation, double f) {
+    switch (relation) {
+        case RELATION_LESS: return f < 0;
+        case RELATION_LESS_EQUAL: return f <= 0;
+        case RELATION_GREATER: return f > 0;
+        case RELATION_GREATER_EQUAL: return f >= 0;
+        default: return f == 0;
+    }
+}
+
+// 1 when the bounds prove the relation everywhere in the tile, 0 when they prove it
+// nowhere, -1 when the tile straddles the boundary
+static int relation_holds_interval(Relation relation, Interval f) {
+    if (relation_holds(relation, f.lo) && relation_holds(relation, f.hi)) return 1;
+    if (!(f.lo <= f.hi)) return -1;
+    switch (relation) {
+        case RELATION_LESS: return f.lo >= 0 ? 0 : -1;
+        case RELATION_LESS_EQUAL: return f.lo > 0 ? 0 : -1;
+        case RELATION_GREATER: return f.hi <= 0 ? 0 : -1;
+        case RELATION_GREATER_EQUAL: return f.hi < 0 ? 0 : -1;
+        default: return -1;
+    }
+}
+
+// Rows [r0, r1) by columns [c0, c1). Tiles of at most REGION_LEAF_CELLS cells are left
+// for point evaluation; interval bounds cost more than that many point evaluations.
+static void shade_tile(RegionSearch* search, int r0, int r1, int c0, int c1) {
+    int area = (r1 - r0) * (c1 - c0);
+    if (area <= 0) return;
+
+    if (area > REGION_LEAF_CELLS) {
+        Interval x_range = {search->x_min + c0 * search->cell, search->x_min + c1 * search->cell};
+        Interval y_range = {search->y_max - r1 * search->cell, search->y_max - r0 * search->cell};
+        // A tile reaching outside F's domain holds nowhere there, so it is never filled
+        int undefined = 0;
+        Interval f = residual_interval(search->eq, x_range, y_range, &undefined);
+        int inside = relation_holds_interval(search->eq->relation, f);
+        if (undefined && inside == 1) inside = -1;
+        if (inside >= 0) {
+            STATS_ADD(search->ctx, region_tiles, 1);
+            for (int r = r0; r < r1 && inside; r++) {
+                memset(search->mask + (size_t)r * search->width + c0, 1, c1 - c0);
+            }
+            return;
+        }
+
+        int r_mid = (r0 + r1) / 2, c_mid = (c0 + c1) / 2;
+        shade_tile(search, r0, r_mid, c0, c_mid);
+        shade_tile(search, r0, r_mid, c_mid, c1);
+        shade_tile(search, r_mid, r1, c0, c_mid);
+        shade_tile(search, r_mid, r1, c_mid, c1);
+        return;
+    }
+
+    for (int r = r0; r < r1; r++) {
+        for (int c = c0; c < c1; c++) search->pending[search->num_pending++] = r * search->width + c;
+    }
+}
+
+// Fill mask (height rows of width cells, row 0 at the top) with 1 where eq's relation
+// holds at the cell centre. Cells are squares of side cell; the top-left cell's box
+// starts at x_min and ends at y_max. Boundary cells are evaluated in one batch.
+int shade_region(Context* ctx, const Equation* eq, double x_min, double y_max, double cell, 
+                 int width, int height, unsigned char* mask) {
+    size_t num_cells = (size_t)width * height;
+    memset(mask, 0, num_cells);
+    int* pending = malloc(num_cells * sizeof(int));
+    if (!pending) return -1;
+
+    RegionSearch search = {ctx, eq, x_min, y_max, cell, width, mask, pending, 0};
+    shade_tile(&search, 0, height, 0, width);
+    STATS_ADD(ctx, region_cells, search.num_pending);
+    if (search.num_pending == 0) {
+        free(pending);
+        return 0;
+    }
+
+    double* xs = malloc(3 * (size_t)search.num_pending * sizeof(double));
+    if (!xs) {
+        free(pending);
+        return -1;
+    }
+    double* ys = xs + search.num_pending;
+    double* f = ys + search.num_pending;
+    for (int i = 0; i < search.num_pending; i++) {
+        xs[i] = x_min + (pending[i] % width + 0.5) * cell;
+        ys[i] = y_max - (pending[i] / width + 0.5) * cell;
+    }
+    if (eq->residual.length >= 0) {
+        program_eval_batch(&eq->residual, xs, ys, f, search.num_pending);
+    } else {
+        for (int i = 0; i < search.num_pending; i++) {
+            f[i] = evaluate_expression((Token*)eq->left_tokens, eq->left_num_tokens, xs[i], ys[i]) - 
+                   evaluate_expression((Token*)eq->right_tokens, eq->right_num_tokens, xs[i], ys[i]);
+        }
+    }
+    for (int i = 0; i < search.num_pending; i++) mask[pending[i]] = relation_holds(eq->relation, f[i]);
+
+    free(xs);
+    free(pending);
+    return 0;
+}
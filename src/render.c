@@ -0,0 +1,626 @@
+// Character-grid rendering shared by the interactive program and other clients
+#include "graphcalc_internal.h"
+
+const int ANSI_CURVE_COLORS[NUM_CURVE_COLORS] = {
+    34, 31, 32, 35, 33, 36, 94, 91, 92, 95, 93, 96
+};
+const unsigned char RGB_CURVE_COLORS[NUM_CURVE_COLORS][3] = {
+    {20, 70, 200}, {200, 30, 30}, {30, 150, 50}, {150, 40, 170}, {200, 140, 0}, {0, 150, 160},
+    {90, 140, 255}, {255, 90, 90}, {80, 210, 90}, {220, 100, 230}, {230, 190, 40}, {40, 200, 210}
+};
+
+// Draw a line between two points using Bresenham's algorithm
+void draw_line(int x_start, int y_start, int x_end, int y_end, PlotPointFn plot, void* target) {
+    int dx = abs(x_end - x_start);
+    int dy = -abs(y_end - y_start);
+    int sx = x_start < x_end ? 1 : -1;
+    int sy = y_start < y_end ? 1 : -1;
+    int err = dx + dy;
+    int x = x_start;
+    int y = y_start;
+
+    while (1) {
+        plot(target, x, y);
+        if (x == x_end && y == y_end) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+    }
+}
+
+// Frame plus the curve currently being drawn into it and its glyph
+typedef struct {
+    Frame* frame;
+    int curve;
+    char glyph;
+} GridTarget;
+
+// Line interpolation on the character grid never overwrites axes or points
+static void plot_grid_point(void* target, int x, int y) {
+    GridTarget* t = target;
+    if (y >= 0 && y < GRID_HEIGHT && x >= 0 && x < GRID_WIDTH) {
+        if (t->frame->grid[y][x] == ' ') {
+            t->frame->grid[y][x] = t->glyph;
+            t->frame->owner[y][x] = (signed char)t->curve;
+        }
+    }
+}
+
+// Shared state for solving one frame's x samples. Sample s sits at column
+// s / COLUMN_SLOTS plus (s % COLUMN_SLOTS) / COLUMN_SLOTS; only solved ones are drawn.
+typedef struct {
+    Context* ctx;
+    const Equation* const* eqs;
+    int num_equations;
+    PlotSettings settings;
+    int deep;
+    int use_float;
+    double y_origin;
+    int min_span;  // Refinement stops at this many slots
+    size_t stride;
+    double* roots;
+    unsigned char* solved;
+} SamplePlan;
+
+static void solve_slot(const SamplePlan* plan, int s) {
+    PlotSettings settings = plan->settings;
+    double x_step = (s - GRID_WIDTH / 2 * COLUMN_SLOTS) / (5.0 * settings.zoom * COLUMN_SLOTS);
+    double* roots = plan->roots + s * plan->stride;
+    if (plan->deep) {
+        DoubleDouble x_val = dd_add_d((DoubleDouble){settings.x_offset, settings.x_offset_lo}, x_step);
+        sample_all_roots_deep(plan->ctx, plan->eqs, plan->num_equations, x_val, settings, roots);
+    } else if (plan->use_float) {
+        sample_all_roots_float(plan->ctx, plan->eqs, plan->num_equations, x_step + settings.x_offset, 
+                               settings, roots);
+    } else {
+        sample_all_roots(plan->ctx, plan->eqs, plan->num_equations, x_step + settings.x_offset, roots);
+    }
+    plan->solved[s] = 1;
+    STATS_ADD(plan->ctx, x_samples, 1);
+}
+
+// Whether the roots at slot m are not already drawn well by joining slots a and b:
+// a root in view that lies off every chord by more than ADAPTIVE_TOLERANCE rows,
+// or a seed whose root appears or vanishes between a and b near the view
+static int slots_need_split(const SamplePlan* plan, int a, int m, int b) {
+    double rows_per_unit = 5.0 * plan->settings.zoom;
+    for (size_t e = 0; e < plan->stride; e += NUM_INITIAL_GUESSES) {
+        const double* ra = plan->roots + a * plan->stride + e;
+        const double* rm = plan->roots + m * plan->stride + e;
+        const double* rb = plan->roots + b * plan->stride + e;
+
+        for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+            double ends[3] = {ra[k], rm[k], rb[k]};
+            int finite = isfinite(ra[k]) + isfinite(rm[k]) + isfinite(rb[k]);
+            if (finite != 0 && finite != 3) {
+                for (int i = 0; i < 3; i++) {
+                    double row = GRID_HEIGHT / 2 - (ends[i] - plan->y_origin) * rows_per_unit;
+                    if (isfinite(ends[i]) && row > -1 && row < GRID_HEIGHT + 1) return 1;
+                }
+                continue;
+            }
+            if (finite == 0) continue;
+
+            double row = GRID_HEIGHT / 2 - (rm[k] - plan->y_origin) * rows_per_unit;
+            if (row <= -1 || row >= GRID_HEIGHT + 1) continue;
+
+            // Seeds swap roots as x moves, so any seed's chord may account for this root
+            int covered = 0;
+            for (int c = 0; c < NUM_INITIAL_GUESSES && !covered; c++) {
+                double chord = 0.5 * (ra[c] + rb[c]);
+                covered = fabs(rm[k] - chord) * rows_per_unit <= ADAPTIVE_TOLERANCE;
+            }
+            if (!covered) return 1;
+        }
+    }
+    return 0;
+}
+
+// Bisect the slots between solved samples a and b while the curve strays from the chord
+static void refine_slots(const SamplePlan* plan, int a, int b) {
+    if (b - a <= plan->min_span) return;
+    int m = (a + b) / 2;
+    solve_slot(plan, m);
+    if (slots_need_split(plan, a, m, b)) {
+        refine_slots(plan, a, m);
+        refine_slots(plan, m, b);
+    }
+}
+
+// Overlay value at one sample, mapped to a row clamped just outside the grid, and
+// whether it joins the previous one
+typedef struct {
+    int row;
+    int has_prev;
+} OverlayTrace;
+
+static void trace_overlay(OverlayTrace* trace, GridTarget* target, int j, double value, 
+                          double y_offset, double zoom) {
+    if (!isfinite(value)) {
+        trace->has_prev = 0;
+        return;
+    }
+    double row = GRID_HEIGHT / 2 - (value - y_offset) * 5.0 * zoom;
+    int in_view = row > -1 && row < GRID_HEIGHT;
+    int plot_y = in_view ? (int)row : (row <= -1 ? -1 : GRID_HEIGHT);
+    int prev_in_view = trace->row >= 0 && trace->row < GRID_HEIGHT;
+    if (in_view) plot_grid_point(target, j, plot_y);
+    if (trace->has_prev && (in_view || prev_in_view)) {
+        draw_line(j - 1 < 0 ? 0 : j - 1, trace->row, j, plot_y, plot_grid_point, target);
+    }
+    trace->row = plot_y;
+    trace->has_prev = 1;
+}
+
+// Solved samples of explicit equation e in x order: x, f(x), the column each falls in
+// and whether the curve runs on unbroken from the previous sample. Returns how many.
+static int explicit_samples(const SamplePlan* plan, int e, double* xs, double* fs, int* cols, 
+                            unsigned char* joined) {
+    PlotSettings settings = plan->settings;
+    double cell = 1.0 / (5.0 * settings.zoom);
+    int n = 0;
+    for (int s = 0; s <= GRID_WIDTH * COLUMN_SLOTS; s++) {
+        if (!plan->solved[s]) continue;
+        double x = (s - GRID_WIDTH / 2 * COLUMN_SLOTS) * cell / COLUMN_SLOTS + settings.x_offset;
+
+        // Every seed lands on the same root of an explicit equation
+        const double* roots = plan->roots + s * plan->stride + e * NUM_INITIAL_GUESSES;
+        double f = NAN;
+        for (int k = 0; k < NUM_INITIAL_GUESSES && !isfinite(f); k++) f = roots[k];
+
+        xs[n] = x;
+        fs[n] = f;
+        cols[n] = s / COLUMN_SLOTS < GRID_WIDTH ? s / COLUMN_SLOTS : GRID_WIDTH - 1;
+        joined[n] = n > 0 && isfinite(f) && isfinite(fs[n - 1]) && 
+                    (fabs(f - fs[n - 1]) <= cell || 
+                     roots_connected(plan->ctx, plan->eqs[e], xs[n - 1], fs[n - 1], x, f, cell));
+        n++;
+    }
+    return n;
+}
+
+// Derivative and running integral of explicit equation e over its solved samples:
+// f' by forward-mode AD on the residual, and the integral by a Kahan-compensated
+// trapezoid sum. Both break, and the integral restarts from 0, wherever f is
+// undefined or the curve itself breaks.
+static void draw_overlays(const SamplePlan* plan, Frame* frame, int e, unsigned overlays, 
+                          const double* xs, const double* fs, const int* cols, 
+                          const unsigned char* joined, int n) {
+    PlotSettings settings = plan->settings;
+    GridTarget derivative_target = {frame, e, DERIVATIVE_GLYPH};
+    GridTarget integral_target = {frame, e, INTEGRAL_GLYPH};
+    OverlayTrace derivative = {0, 0}, integral_trace = {0, 0};
+    double integral = 0, compensation = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (!joined[i]) {
+            derivative.has_prev = integral_trace.has_prev = 0;
+            integral = compensation = 0;
+        } else {
+            double term = 0.5 * (xs[i] - xs[i - 1]) * (fs[i] + fs[i - 1]) - compensation;
+            double sum = integral + term;
+            compensation = (sum - integral) - term;
+            integral = sum;
+        }
+
+        if (overlays & GC_OVERLAY_DERIVATIVE) {
+            Dual d = isfinite(fs[i]) ? residual_dual(plan->eqs[e], xs[i], fs[i]) : (Dual){NAN, NAN, NAN};
+            trace_overlay(&derivative, &derivative_target, cols[i], -d.dx / d.dy, settings.y_offset, 
+                          settings.zoom);
+        }
+        if (overlays & GC_OVERLAY_INTEGRAL) {
+            trace_overlay(&integral_trace, &integral_target, cols[i], isfinite(fs[i]) ? integral : NAN, 
+                          settings.y_offset, settings.zoom);
+        }
+    }
+}
+
+// Render all equations into one frame. The x samples and axes are shared, and every
+// equation is solved at each sample in a single parallel pass before drawing.
+static int render_pass(Context* ctx, Frame* frame, const Equation* const* eqs, int num_equations, 
+                       PlotSettings settings, const Marker* markers, int num_markers, 
+                       int use_float) {
+    char (*grid)[GRID_WIDTH] = frame->grid;
+    signed char (*owner)[GRID_WIDTH] = frame->owner;
+    memset(frame->grid, ' ', sizeof(frame->grid));
+    memset(frame->owner, -1, sizeof(frame->owner));
+
+    // Calculate axes positions; far-off axes are parked outside the grid
+    double axis_x = GRID_WIDTH / 2 - settings.x_offset * 5.0 * settings.zoom;
+    double axis_y = GRID_HEIGHT / 2 + settings.y_offset * 5.0 * settings.zoom;
+    int center_x = fabs(axis_x) < GRID_WIDTH * 2 ? (int)axis_x : -1;
+    int center_y = fabs(axis_y) < GRID_HEIGHT * 2 ? (int)axis_y : -1;
+
+    // Draw axes
+    for (int i = 0; i < GRID_HEIGHT; i++) {
+        for (int j = 0; j < GRID_WIDTH; j++) {
+            if (i == center_y) grid[i][j] = (j % 2 == 0) ? '+' : '-';
+            if (j == center_x) grid[i][j] = (i % 2 == 0) ? '+' : '|';
+        }
+    }
+
+    // Solve every equation at each column edge, then refine each column adaptively
+    // down to 1 / COLUMN_SLOTS of a column where the curve bends or steepens
+    int num_samples = GRID_WIDTH * COLUMN_SLOTS + 1;
+    size_t stride = (size_t)num_equations * NUM_INITIAL_GUESSES;
+    double* roots = malloc(num_samples * stride * sizeof(double));
+    unsigned char* solved = calloc(num_samples, 1);
+    if (!roots || !solved) {
+        free(roots);
+        free(solved);
+        return -1;
+    }
+
+    // Past double precision, switch to double-double; roots then come back relative
+    // to the view's y centre, so rows are mapped with a zero offset
+    int deep = view_needs_double_double(settings);
+    for (int e = 0; e < num_equations; e++) {
+        deep &= eqs[e]->kind != EQUATION_IMPLICIT || eqs[e]->residual.length >= 0;
+    }
+    double y_origin = deep ? 0.0 : settings.y_offset;
+    int refine_depth = ctx ? ctx->refine_depth : ADAPTIVE_MAX_DEPTH;
+    int min_span = refine_depth < ADAPTIVE_MAX_DEPTH ? COLUMN_SLOTS >> refine_depth : 1;
+    SamplePlan plan = {ctx, eqs, num_equations, settings, deep, use_float, y_origin, min_span, 
+                       stride, roots, solved};
+
+    STATS_TIMER_START(solve_start);
+    #pragma omp parallel for schedule(dynamic, 4)
+    for (int j = 0; j <= GRID_WIDTH; j++) solve_slot(&plan, j * COLUMN_SLOTS);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int j = 0; j < GRID_WIDTH; j++) refine_slots(&plan, j * COLUMN_SLOTS, (j + 1) * COLUMN_SLOTS);
+
+    // Parametric and polar curves need no roots: each is traced over its parameter range
+    CurveTrace traces[MAX_EQUATIONS];
+    int trace_status = 0;
+    for (int e = 0; e < num_equations; e++) {
+        traces[e].x = traces[e].y = NULL;
+        traces[e].count = 0;
+        if (eqs[e]->kind != EQUATION_IMPLICIT && trace_status == 0) {
+            trace_status = trace_parametric(ctx, eqs[e], settings, &traces[e]);
+        }
+    }
+    STATS_TIMER_STOP(ctx, STAGE_SOLVE, solve_start);
+    if (trace_status != 0) {
+        for (int e = 0; e < num_equations; e++) free_curve_trace(&traces[e]);
+        free(roots);
+        free(solved);
+        return -1;
+    }
+
+#ifdef GRAPHCALC_STATS
+    for (size_t r = 0; r < num_samples * stride; r += NUM_INITIAL_GUESSES) {
+        if (!solved[r / stride]) continue;
+        double distinct[NUM_INITIAL_GUESSES];
+        int found = 0;
+        for (int k = 0; k < NUM_INITIAL_GUESSES; k++) found += isfinite(roots[r + k]);
+        STATS_ADD(ctx, roots_found, found);
+        STATS_ADD(ctx, roots_distinct, collect_distinct_roots(roots + r, NUM_INITIAL_GUESSES, 
+                                                         ROOT_TOLERANCE, distinct));
+    }
+#endif
+
+    STATS_TIMER_START(rasterize_start);
+
+    // Store previous valid points for line interpolation, with the root they came
+    // from so joins spanning more than a row can be checked for discontinuities
+    int prev_plot_y[MAX_EQUATIONS][NUM_INITIAL_GUESSES];
+    double prev_x[MAX_EQUATIONS][NUM_INITIAL_GUESSES];
+    double prev_y[MAX_EQUATIONS][NUM_INITIAL_GUESSES];
+    int has_prev[MAX_EQUATIONS][NUM_INITIAL_GUESSES];
+    memset(has_prev, 0, sizeof(has_prev));
+    double cell = 1.0 / (5.0 * settings.zoom);
+
+    GridTarget target = {frame, 0, CURVE_GLYPHS[0]};
+    for (int s = 0; s < GRID_WIDTH * COLUMN_SLOTS; s++) {
+        if (!solved[s]) continue;
+        int j = s / COLUMN_SLOTS;
+        double x_val = (s - GRID_WIDTH / 2 * COLUMN_SLOTS) * cell / COLUMN_SLOTS + settings.x_offset;
+
+        for (int e = 0; e < num_equations; e++) {
+            target.curve = e;
+            target.glyph = CURVE_GLYPHS[e];
+            JoinCache joins;
+            joins.count = 0;
+
+            for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+                double y_val = roots[s * stride + e * NUM_INITIAL_GUESSES + k];
+
+                if (!isnan(y_val) && !isinf(y_val)) {
+                    double row = GRID_HEIGHT / 2 - y_val * 5.0 * settings.zoom 
+                                 + y_origin * 5.0 * settings.zoom;
+
+                    // Rows truncate toward zero, as the cast always did; points off the
+                    // grid are clamped just outside it so joins still reach the edge
+                    int in_view = row > -1 && row < GRID_HEIGHT;
+                    int plot_y = in_view ? (int)row : (row <= -1 ? -1 : GRID_HEIGHT);
+                    if (in_view) {
+                        // Mark the main point
+                        grid[plot_y][j] = CURVE_GLYPHS[e];
+                        owner[plot_y][j] = (signed char)e;
+                    }
+
+                    // If we have a previous point for this guess, interpolate unless both
+                    // are off the grid or a pole or a gap between branches lies in between.
+                    // Deep views are beyond double resolution, so they always join.
+                    int prev_in_view = prev_plot_y[e][k] >= 0 && prev_plot_y[e][k] < GRID_HEIGHT;
+                    if (has_prev[e][k] && j > 0 && (in_view || prev_in_view) && 
+                        (abs(plot_y - prev_plot_y[e][k]) <= 1 || deep || 
+                         join_cache_connected(&joins, ctx, eqs[e], prev_x[e][k], prev_y[e][k], 
+                                              x_val, y_val, cell))) {
+                        draw_line(j - 1, prev_plot_y[e][k], j, plot_y, plot_grid_point, &target);
+                    }
+
+                    // Store current point as previous for next iteration
+                    prev_plot_y[e][k] = plot_y;
+                    prev_x[e][k] = x_val;
+                    prev_y[e][k] = y_val;
+                    has_prev[e][k] = 1;
+                }
+            }
+        }
+    }
+
+    // Overlays and feature points need f in plain double, so double-double views leave
+    // them out
+    unsigned overlays = ctx && !deep ? ctx->overlays : 0;
+    double* xs = overlays ? malloc(num_samples * 2 * sizeof(double)) : NULL;
+    int* cols = overlays ? malloc(num_samples * sizeof(int)) : NULL;
+    unsigned char* joined = overlays ? malloc(num_samples) : NULL;
+    if (overlays && (!xs || !cols || !joined)) overlays = 0;
+    frame->num_features = 0;
+    for (int e = 0; e < num_equations && overlays; e++) {
+        if (eqs[e]->kind != EQUATION_IMPLICIT || !eqs[e]->analysis.explicit_y) continue;
+        double* fs = xs + num_samples;
+        int n = explicit_samples(&plan, e, xs, fs, cols, joined);
+        draw_overlays(&plan, frame, e, overlays, xs, fs, cols, joined, n);
+        if (overlays & GC_OVERLAY_FEATURES) {
+            frame->num_features = find_features(eqs[e], e, xs, joined, n, settings, 
+                                                frame->features, frame->num_features);
+        }
+    }
+    free(xs);
+    free(cols);
+    free(joined);
+    free(roots);
+    free(solved);
+
+    // Join consecutive traced points; a jump of more than PARAM_JOIN_CELLS survived the
+    // refinement, so it is a pole or a gap in the domain rather than part of the curve
+    double scale = 5.0 * settings.zoom;
+    for (int e = 0; e < num_equations; e++) {
+        target.curve = e;
+        target.glyph = CURVE_GLYPHS[e];
+        int has_prev = 0;
+        double prev_col = 0, prev_row = 0;
+        for (int i = 0; i < traces[e].count; i++) {
+            double col = GRID_WIDTH / 2 + (traces[e].x[i] - settings.x_offset) * scale;
+            double row = GRID_HEIGHT / 2 - (traces[e].y[i] - settings.y_offset) * scale;
+            if (!isfinite(col) || !isfinite(row)) {
+                has_prev = 0;
+                continue;
+            }
+
+            if (col >= 0 && col < GRID_WIDTH && row >= 0 && row < GRID_HEIGHT) {
+                grid[(int)row][(int)col] = CURVE_GLYPHS[e];
+                owner[(int)row][(int)col] = (signed char)e;
+            }
+            if (has_prev && fabs(col - prev_col) <= PARAM_JOIN_CELLS && 
+                fabs(row - prev_row) <= PARAM_JOIN_CELLS && 
+                fmax(col, prev_col) >= -1 && fmin(col, prev_col) <= GRID_WIDTH && 
+                fmax(row, prev_row) >= -1 && fmin(row, prev_row) <= GRID_HEIGHT) {
+                draw_line((int)floor(prev_col), (int)floor(prev_row), (int)floor(col), 
+                          (int)floor(row), plot_grid_point, &target);
+            }
+            prev_col = col;
+            prev_row = row;
+            has_prev = 1;
+        }
+        free_curve_trace(&traces[e]);
+    }
+
+    // Contours, one glyph per level, then inequality regions go into the cells nothing
+    // else has drawn on
+    double x_min = settings.x_offset - GRID_WIDTH / 2 * cell;
+    double y_max = settings.y_offset + GRID_HEIGHT / 2 * cell;
+    signed char levels[GRID_HEIGHT * GRID_WIDTH];
+    for (int e = 0; e < num_equations; e++) {
+        if (eqs[e]->kind != EQUATION_CONTOUR) continue;
+        if (contour_levels(ctx, eqs[e], x_min, y_max, cell, GRID_WIDTH, GRID_HEIGHT, levels) != 0) {
+            return -1;
+        }
+        for (int i = 0; i < GRID_HEIGHT; i++) {
+            for (int j = 0; j < GRID_WIDTH; j++) {
+                if (levels[i * GRID_WIDTH + j] >= 0 && grid[i][j] == ' ') {
+                    grid[i][j] = CONTOUR_GLYPHS[(int)levels[i * GRID_WIDTH + j]];
+                    owner[i][j] = (signed char)e;
+                }
+            }
+        }
+    }
+
+    unsigned char region[GRID_HEIGHT * GRID_WIDTH];
+    for (int e = 0; e < num_equations; e++) {
+        if (eqs[e]->kind != EQUATION_IMPLICIT || eqs[e]->relation == RELATION_EQUAL) continue;
+        if (shade_region(ctx, eqs[e], x_min, y_max, cell, GRID_WIDTH, GRID_HEIGHT, region) != 0) {
+            return -1;
+        }
+        for (int i = 0; i < GRID_HEIGHT; i++) {
+            for (int j = 0; j < GRID_WIDTH; j++) {
+                if (region[i * GRID_WIDTH + j] && grid[i][j] == ' ') {
+                    grid[i][j] = REGION_GLYPH;
+                    owner[i][j] = (signed char)e;
+                }
+            }
+        }
+    }
+
+    // Feature points, then markers, go on top of everything else
+    for (int m = 0; m < frame->num_features; m++) {
+        const Marker* feature = &frame->features[m];
+        double row = floor(GRID_HEIGHT / 2 - (feature->y - settings.y_offset) * 5.0 * settings.zoom);
+        double col = floor(GRID_WIDTH / 2 + (feature->x - settings.x_offset) * 5.0 * settings.zoom);
+        if (row >= 0 && row < GRID_HEIGHT && col >= 0 && col < GRID_WIDTH) {
+            int i = (int)row, j = (int)col;
+            grid[i][j] = feature->glyph;
+            owner[i][j] = -1;
+        }
+    }
+    for (int m = 0; m < num_markers; m++) {
+        double row = floor(GRID_HEIGHT / 2 - (markers[m].y - settings.y_offset) * 5.0 * settings.zoom);
+        double col = floor(GRID_WIDTH / 2 + (markers[m].x - settings.x_offset) * 5.0 * settings.zoom);
+        if (row >= 0 && row < GRID_HEIGHT && col >= 0 && col < GRID_WIDTH) {
+            int i = (int)row, j = (int)col;
+            grid[i][j] = markers[m].glyph;
+            owner[i][j] = -1;
+        }
+    }
+    STATS_TIMER_STOP(ctx, STAGE_RASTERIZE, rasterize_start);
+    return 0;
+}
+
+// Colour the frame's heat map, when the context asks for one, from the first equation
+// that has a residual over the whole view
+static void render_heat_map(Context* ctx, Frame* frame, const Equation* const* eqs, 
+                            int num_equations, PlotSettings settings) {
+    frame->heat_map = GC_HEAT_OFF;
+    if (!ctx || ctx->heat_map == GC_HEAT_OFF) return;
+    STATS_TIMER_START(heat_start);
+    for (int e = 0; e < num_equations; e++) {
+        if (eqs[e]->kind != EQUATION_IMPLICIT && eqs[e]->kind != EQUATION_CONTOUR) continue;
+        if (heat_map_colors(ctx, eqs[e], settings, ctx->heat_map, &frame->heat[0][0]) == 0) {
+            frame->heat_map = ctx->heat_map;
+        }
+        break;
+    }
+    STATS_TIMER_STOP(ctx, STAGE_RASTERIZE, heat_start);
+}
+
+// Render with the context's precision: single precision where the view allows it
+// unless the context asks for doubles, or both ways when validating
+int render_frame(Context* ctx, Frame* frame, const Equation* const* eqs, int num_equations, 
+                 PlotSettings settings, const Marker* markers, int num_markers) {
+    gc_precision precision = ctx ? ctx->precision : GC_PRECISION_FAST;
+    int use_float = precision != GC_PRECISION_DOUBLE && view_fits_float(settings);
+    if (ctx) ctx->float_mismatches = -1;
+    if (precision != GC_PRECISION_VALIDATE || !use_float) {
+        if (render_pass(ctx, frame, eqs, num_equations, settings, markers, num_markers, use_float) != 0) {
+            return -1;
+        }
+        render_heat_map(ctx, frame, eqs, num_equations, settings);
+        return 0;
+    }
+
+    Frame float_frame;
+    if (render_pass(ctx, &float_frame, eqs, num_equations, settings, markers, num_markers, 1) != 0 || 
+        render_pass(ctx, frame, eqs, num_equations, settings, markers, num_markers, 0) != 0) {
+        return -1;
+    }
+    int mismatches = 0;
+    for (int i = 0; i < GRID_HEIGHT; i++) {
+        for (int j = 0; j < GRID_WIDTH; j++) mismatches += float_frame.grid[i][j] != frame->grid[i][j];
+    }
+    ctx->float_mismatches = mismatches;
+    render_heat_map(ctx, frame, eqs, num_equations, settings);
+    return 0;
+}
+
+// Print a rendered frame with its border, legend and marker list
+void print_frame(Context* ctx, const Frame* frame, FILE* out, const Equation* const* eqs, 
+                 int num_equations, PlotSettings settings, PlotOptions options, 
+                 const Marker* markers, int num_markers) {
+    STATS_TIMER_START(emit_start);
+
+    // Draw the plot
+    fprintf(out, "\n+");
+    for (int j = 0; j < GRID_WIDTH; j++) fprintf(out, "-");
+    fprintf(out, "+\n");
+
+    int use_heat = frame->heat_map != GC_HEAT_OFF;
+    for (int i = 0; i < GRID_HEIGHT; i++) {
+        fprintf(out, "|");
+        int color = -1, background = -1;
+        for (int j = 0; j < GRID_WIDTH; j++) {
+            // Only emit an escape code where the colour actually changes, so runs of
+            // one colour cost a single escape
+            if (options.use_color && frame->owner[i][j] != color) {
+                color = frame->owner[i][j];
+                if (color < 0) fprintf(out, use_heat ? "\x1b[39m" : "\x1b[0m");
+                else fprintf(out, "\x1b[%dm", ANSI_CURVE_COLORS[color % NUM_CURVE_COLORS]);
+            }
+            if (use_heat && frame->heat[i][j] != background) {
+                background = frame->heat[i][j];
+                if (background < 0) fprintf(out, "\x1b[49m");
+                else if (frame->heat_map == GC_HEAT_256) fprintf(out, "\x1b[48;5;%dm", background);
+                else fprintf(out, "\x1b[48;2;%d;%d;%dm", background >> 16, (background >> 8) & 255, 
+                             background & 255);
+            }
+            fprintf(out, "%c", frame->grid[i][j]);
+        }
+        if (color >= 0 || background >= 0) fprintf(out, "\x1b[0m");
+        fprintf(out, "|\n");
+    }
+
+    fprintf(out, "+");
+    for (int j = 0; j < GRID_WIDTH; j++) fprintf(out, "-");
+    fprintf(out, "+\n");
+
+    // Legend, only needed once curves have to be told apart
+    if (num_equations > 1) {
+        for (int e = 0; e < num_equations; e++) {
+            if (options.use_color) {
+                fprintf(out, "  \x1b[%dm%c\x1b[0m %s\n", ANSI_CURVE_COLORS[e % NUM_CURVE_COLORS], 
+                       CURVE_GLYPHS[e], eqs[e]->text);
+            } else {
+                fprintf(out, "  %c %s\n", CURVE_GLYPHS[e], eqs[e]->text);
+            }
+        }
+    }
+
+    unsigned overlays = ctx && !view_needs_double_double(settings) ? ctx->overlays : 0;
+    for (int e = 0; e < num_equations && overlays; e++) {
+        if (eqs[e]->kind != EQUATION_IMPLICIT || !eqs[e]->analysis.explicit_y) continue;
+        if (overlays & GC_OVERLAY_DERIVATIVE) fprintf(out, "  %c d/dx of %s\n", DERIVATIVE_GLYPH, eqs[e]->text);
+        if (overlays & GC_OVERLAY_INTEGRAL) {
+            fprintf(out, "  %c integral of %s from the left edge\n", INTEGRAL_GLYPH, eqs[e]->text);
+        }
+    }
+
+    // Contour glyphs stand for levels, listed per contour plot
+    for (int e = 0; e < num_equations; e++) {
+        if (eqs[e]->kind != EQUATION_CONTOUR) continue;
+        fprintf(out, "  Levels of %s:", eqs[e]->text);
+        for (int l = 0; l < eqs[e]->num_levels; l++) {
+            fprintf(out, "%s %c = %g", l > 0 ? "," : "", CONTOUR_GLYPHS[l], eqs[e]->levels[l]);
+        }
+        fprintf(out, "\n");
+    }
+
+    // Feature points carry every digit they were solved to
+    if (frame->num_features > 0) {
+        fprintf(out, "\n");
+        for (int m = 0; m < frame->num_features; m++) {
+            const Marker* feature = &frame->features[m];
+            fprintf(out, "  %c %-24s (%.17g, %.17g)\n", feature->glyph, feature->label, 
+                    feature->x, feature->y);
+        }
+    }
+
+    if (num_markers > 0) {
+        fprintf(out, "\n");
+        for (int m = 0; m < num_markers; m++) {
+            fprintf(out, "  %c %-24s (%.10g, %.10g)\n", markers[m].glyph, markers[m].label, 
+                   markers[m].x, markers[m].y);
+        }
+    }
+
+    if (view_needs_double_double(settings)) {
+        fprintf(out, "\nPlot (Zoom: %.3e, Offset: %.17g, %.17g, double-double)\n", 
+               settings.zoom, settings.x_offset + settings.x_offset_lo, 
+               settings.y_offset + settings.y_offset_lo);
+    } else {
+        fprintf(out, "\nPlot (Zoom: %.2f, Offset: %.2f, %.2f)\n", 
+               settings.zoom, settings.x_offset, settings.y_offset);
+    }
+    STATS_TIMER_STOP(ctx, STAGE_EMIT, emit_start);
+}
@@ -0,0 +1,429 @@
+// Equation parsing and the Newton solver with its multi-seed root sampling
+#include "graphcalc_internal.h"
+
+// Analysis pass over both sides. The seed range comes from interval bounds when y
+// is explicit (coef * y + g(x) with g bounded for every x); otherwise it falls back
+// on the functions present.
+static void analyze_equation(Equation* eq) {
+    ExprShape shape = combine_shapes(analyze_expression(eq->left_tokens, eq->left_num_tokens), 
+                                     analyze_expression(eq->right_tokens, eq->right_num_tokens), '-');
+    EquationAnalysis* info = &eq->analysis;
+    info->flags = shape.flags;
+    info->shape = shape.kind;
+    info->y_periodic = shape.kind == SHAPE_PERIODIC;
+    info->explicit_y = shape.kind == SHAPE_AFFINE && shape.coef != 0 && isfinite(shape.coef);
+    info->y_coef = info->explicit_y ? shape.coef : 0;
+
+    info->seed_min = -5; info->seed_max = 5;
+    if (info->y_periodic) {
+        info->seed_min = -PI; info->seed_max = PI;
+        return;
+    }
+    // Bounds that hold for one parameter value say nothing about the next
+    if (shape.kind == SHAPE_AFFINE && !(shape.flags & ANALYSIS_PARAMETER)) {
+        Interval all = {-INFINITY, INFINITY}, zero = {0, 0};
+        Interval l = evaluate_interval(eq->left_tokens, eq->left_num_tokens, all, zero, NULL);
+        Interval r = evaluate_interval(eq->right_tokens, eq->right_num_tokens, all, zero, NULL);
+        double lo = -(l.hi - r.lo) / shape.coef, hi = -(l.lo - r.hi) / shape.coef;
+        if (isfinite(lo) && isfinite(hi)) {
+            info->seed_min = fmin(lo, hi) - 0.5;
+            info->seed_max = fmax(lo, hi) + 0.5;
+            return;
+        }
+    }
+    if (shape.flags & ANALYSIS_SIN_COS) {
+        info->seed_min = -1.5; info->seed_max = 1.5;
+    } else if (shape.flags & ANALYSIS_LOG) {
+        info->seed_min = -10; info->seed_max = 10;
+    }
+}
+
+// Split an equation at the equals sign and tokenize both sides once, resolving the
+// session's symbols when symbols is non-NULL
+void parse_equation(const char* equation, const SymbolTable* symbols, Equation* eq) {
+    char left_side[MAX_EQUATION_LENGTH], right_side[MAX_EQUATION_LENGTH];
+
+    strncpy(eq->text, equation, MAX_EQUATION_LENGTH - 1);
+    eq->text[MAX_EQUATION_LENGTH - 1] = '\0';
+    eq->undefined[0] = '\0';
+    if (parse_parametric(eq, symbols)) return;
+    eq->kind = EQUATION_IMPLICIT;
+    eq->relation = RELATION_EQUAL;
+
+    // Split equation at the relation: <, <=, >, >= or the equals sign
+    const char* equals = strpbrk(eq->text, "<>");
+    if (equals) {
+        int or_equal = equals[1] == '=';
+        eq->relation = *equals == '<' ? (or_equal ? RELATION_LESS_EQUAL : RELATION_LESS) : 
+                                        (or_equal ? RELATION_GREATER_EQUAL : RELATION_GREATER);
+        strncpy(left_side, eq->text, equals - eq->text);
+        left_side[equals - eq->text] = '\0';
+        strcpy(right_side, equals + 1 + or_equal);
+    } else if ((equals = strchr(eq->text, '='))) {
+        strncpy(left_side, eq->text, equals - eq->text);
+        left_side[equals - eq->text] = '\0';
+        strcpy(right_side, equals + 1);
+
+        // A range on the right, "f(x, y) = a..b[, n]", asks for contours of the left side
+        if (strstr(right_side, "..") && (eq->num_levels = parse_levels(right_side, eq->levels)) > 0) {
+            eq->kind = EQUATION_CONTOUR;
+            strcpy(right_side, "0");
+        }
+    } else {
+        strcpy(left_side, eq->text);
+        strcpy(right_side, "0");
+    }
+
+    // Tokenize both sides
+    eq->left_num_tokens = tokenize_resolved(symbols, left_side, eq->left_tokens);
+    eq->right_num_tokens = tokenize_resolved(symbols, right_side, eq->right_tokens);
+    mark_undefined(eq->left_tokens, eq->left_num_tokens, "x", "y", eq->undefined);
+    mark_undefined(eq->right_tokens, eq->right_num_tokens, "x", "y", eq->undefined);
+    compile_residual(eq, &eq->residual);
+    analyze_equation(eq);
+}
+
+// Improved equation solver; reports the Newton iterations used when iterations is non-NULL
+double solve_equation_counted(const Equation* eq, double x, double initial_y, int* iterations) {
+    double y = initial_y;
+    double prev_y;
+    int iter = 0;
+    double h = 1e-7;  // Step size for numerical derivative
+
+    // evaluate_expression takes non-const tokens but never writes to them
+    Token* left_tokens = (Token*)eq->left_tokens;
+    Token* right_tokens = (Token*)eq->right_tokens;
+
+    do {
+        prev_y = y;
+
+        // Evaluate both sides of equation
+        double f = evaluate_expression(left_tokens, eq->left_num_tokens, x, y) - 
+                  evaluate_expression(right_tokens, eq->right_num_tokens, x, y);
+
+        // Compute numerical derivative
+        double f_h = evaluate_expression(left_tokens, eq->left_num_tokens, x, y + h) - 
+                    evaluate_expression(right_tokens, eq->right_num_tokens, x, y + h);
+        double df = (f_h - f) / h;
+
+        // Prevent division by very small numbers
+        if (fabs(df) < EPSILON) {
+            df = (df < 0 ? -EPSILON : EPSILON);
+        }
+
+        // Newton step with dampening
+        double delta = f / df;
+        double damping = 0.5;  // Dampening factor
+        y -= delta * damping;
+
+        // Wrap y when the residual repeats every 2*pi in it
+        if (eq->analysis.y_periodic) {
+            y = fmod(y + PI, 2 * PI) - PI;
+        }
+
+        iter++;
+    } while (fabs(y - prev_y) > EPSILON && iter < MAX_ITER);
+
+    if (iterations) *iterations = iter;
+    return iter < MAX_ITER ? y : NAN;
+}
+
+double solve_equation(const Equation* eq, double x, double initial_y) {
+    return solve_equation_counted(eq, x, initial_y, NULL);
+}
+
+// y range for the initial guesses, fixed by the analysis pass
+void get_seed_range(const Equation* eq, double* y_min, double* y_max) {
+    *y_min = eq->analysis.seed_min;
+    *y_max = eq->analysis.seed_max;
+}
+
+// Run solve_equation_counted from every seed at once: each round evaluates the
+// residual at y and y + h for all unfinished seeds in one batch call, then applies
+// the same damped Newton update per seed. Roots and iteration counts are identical.
+static void solve_seeds_batched(const Equation* eq, double x, const double* initial_y, 
+                                double* roots, int* iterations, int num_seeds) {
+    double y[NUM_INITIAL_GUESSES];
+    int active[NUM_INITIAL_GUESSES];
+    double xs[2 * NUM_INITIAL_GUESSES], ys[2 * NUM_INITIAL_GUESSES], f[2 * NUM_INITIAL_GUESSES];
+    double h = 1e-7;
+    int periodic = eq->analysis.y_periodic;
+    int num_active = num_seeds;
+
+    for (int k = 0; k < num_seeds; k++) {
+        y[k] = initial_y[k];
+        iterations[k] = 0;
+        active[k] = k;
+    }
+
+    while (num_active > 0) {
+        for (int a = 0; a < num_active; a++) {
+            xs[a] = xs[num_active + a] = x;
+            ys[a] = y[active[a]];
+            ys[num_active + a] = y[active[a]] + h;
+        }
+        program_eval_batch(&eq->residual, xs, ys, f, 2 * num_active);
+
+        int still_active = 0;
+        for (int a = 0; a < num_active; a++) {
+            int k = active[a];
+            double prev_y = y[k];
+            double df = (f[num_active + a] - f[a]) / h;
+            if (fabs(df) < EPSILON) {
+                df = (df < 0 ? -EPSILON : EPSILON);
+            }
+            y[k] -= f[a] / df * 0.5;
+            if (periodic) y[k] = fmod(y[k] + PI, 2 * PI) - PI;
+            iterations[k]++;
+
+            if (fabs(y[k] - prev_y) > EPSILON && iterations[k] < MAX_ITER) {
+                active[still_active++] = k;
+            }
+        }
+        num_active = still_active;
+    }
+
+    for (int k = 0; k < num_seeds; k++) {
+        roots[k] = iterations[k] < MAX_ITER ? y[k] : NAN;
+    }
+}
+
+// True when floats can place roots to FLOAT_ROW_TOLERANCE of a row and samples to a
+// small fraction of their spacing everywhere in the view
+int view_fits_float(PlotSettings settings) {
+    double row_height = 1.0 / (5.0 * settings.zoom);
+    double sample_width = row_height / COLUMN_SLOTS;
+    double x_extent = fabs(settings.x_offset) + GRID_WIDTH / 2 * row_height;
+    double y_extent = fabs(settings.y_offset) + GRID_HEIGHT / 2 * row_height;
+    return FLOAT_NOISE_FACTOR * FLT_EPSILON * (1 + y_extent) <= FLOAT_ROW_TOLERANCE * row_height && 
+           FLOAT_NOISE_FACTOR * FLT_EPSILON * (1 + x_extent) <= FLOAT_ROW_TOLERANCE * sample_width;
+}
+
+// Single-precision counterpart of solve_seeds_batched, stopping once steps fall below
+// tolerance rather than EPSILON. A seed is re-solved in double when its root is not
+// trustworthy at that tolerance: the rounding noise of the residual (from the
+// kernel's cancellation scale) moves the root by more than tolerance, or the seed
+// failed while already within that noise of a root. Returns how many were re-solved.
+static int solve_seeds_float(const Equation* eq, double x, const double* initial_y, 
+                             double* roots, int* iterations, int num_seeds, double tolerance) {
+    float y[NUM_INITIAL_GUESSES], residual[NUM_INITIAL_GUESSES], noise[NUM_INITIAL_GUESSES];
+    float slope[NUM_INITIAL_GUESSES];
+    int active[NUM_INITIAL_GUESSES];
+    float xs[2 * NUM_INITIAL_GUESSES], ys[2 * NUM_INITIAL_GUESSES];
+    float f[2 * NUM_INITIAL_GUESSES], scale[2 * NUM_INITIAL_GUESSES];
+    int periodic = eq->analysis.y_periodic;
+    float tol = (float)tolerance;
+    int num_active = num_seeds;
+
+    for (int k = 0; k < num_seeds; k++) {
+        y[k] = (float)initial_y[k];
+        iterations[k] = 0;
+        active[k] = k;
+    }
+
+    while (num_active > 0) {
+        for (int a = 0; a < num_active; a++) {
+            // Derivative step well above float resolution; it only affects the rate
+            float h = 1e-3f * (1 + fabsf(y[active[a]]));
+            xs[a] = xs[num_active + a] = (float)x;
+            ys[a] = y[active[a]];
+            ys[num_active + a] = y[active[a]] + h;
+        }
+        program_eval_batch_float(&eq->residual, xs, ys, f, scale, 2 * num_active);
+
+        int still_active = 0;
+        for (int a = 0; a < num_active; a++) {
+            int k = active[a];
+            float prev_y = y[k];
+            float df = (f[num_active + a] - f[a]) / (ys[num_active + a] - ys[a]);
+            if (fabsf(df) < (float)EPSILON) {
+                df = (df < 0 ? -(float)EPSILON : (float)EPSILON);
+            }
+            residual[k] = f[a];
+            slope[k] = df;
+            noise[k] = FLOAT_NOISE_FACTOR * FLT_EPSILON * fmaxf(scale[a], fabsf(f[a]));
+            y[k] -= f[a] / df * 0.5f;
+            if (periodic) y[k] = fmodf(y[k] + (float)PI, 2 * (float)PI) - (float)PI;
+            iterations[k]++;
+
+            if (fabsf(y[k] - prev_y) > tol && iterations[k] < MAX_ITER) {
+                active[still_active++] = k;
+            }
+        }
+        num_active = still_active;
+    }
+
+    double recheck_y[NUM_INITIAL_GUESSES];
+    int recheck[NUM_INITIAL_GUESSES], num_rechecks = 0;
+    for (int k = 0; k < num_seeds; k++) {
+        int converged = iterations[k] < MAX_ITER && isfinite(y[k]);
+        float root_noise = noise[k] / fabsf(slope[k]) + FLOAT_NOISE_FACTOR * FLT_EPSILON * fabsf(y[k]);
+        int trusted = converged ? !(root_noise > tol) 
+                                : isfinite(residual[k]) && fabsf(residual[k]) > noise[k];
+        if (converged) {
+            // Damping leaves the root about one step short; finish with the other half
+            // of the last Newton step, which is nearly free and quadratically accurate
+            y[k] -= residual[k] / slope[k] * 0.5f;
+            if (periodic) y[k] = fmodf(y[k] + (float)PI, 2 * (float)PI) - (float)PI;
+        }
+        roots[k] = converged ? y[k] : NAN;
+        if (!trusted) {
+            recheck[num_rechecks] = k;
+            recheck_y[num_rechecks++] = initial_y[k];
+        }
+    }
+    if (num_rechecks == 0) return 0;
+
+    double recheck_roots[NUM_INITIAL_GUESSES];
+    int recheck_iterations[NUM_INITIAL_GUESSES];
+    solve_seeds_batched(eq, x, recheck_y, recheck_roots, recheck_iterations, num_rechecks);
+    for (int r = 0; r < num_rechecks; r++) {
+        roots[recheck[r]] = recheck_roots[r];
+        iterations[recheck[r]] += recheck_iterations[r];
+    }
+    return num_rechecks;
+}
+
+// Solve at a fixed x from every initial guess; failed guesses come back as NAN
+void sample_roots(Context* ctx, const Equation* eq, double x_val, double y_min, double y_max, 
+                  double* roots) {
+    double initial_y[NUM_INITIAL_GUESSES];
+    int iterations[NUM_INITIAL_GUESSES];
+    if (eq->kind != EQUATION_IMPLICIT) {
+        // Traced by trace_parametric instead; there are no roots in y to find
+        for (int k = 0; k < NUM_INITIAL_GUESSES; k++) roots[k] = NAN;
+        return;
+    }
+    for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+        initial_y[k] = y_min + (y_max - y_min) * k / (NUM_INITIAL_GUESSES - 1);
+    }
+
+    if (eq->residual.length >= 0) {
+        solve_seeds_batched(eq, x_val, initial_y, roots, iterations, NUM_INITIAL_GUESSES);
+    } else {
+        for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+            roots[k] = solve_equation_counted(eq, x_val, initial_y[k], &iterations[k]);
+        }
+    }
+    for (int k = 0; k < NUM_INITIAL_GUESSES; k++) stats_record_solve(ctx, iterations[k]);
+}
+
+// Solve every equation at one shared x; roots for equation e start at e * NUM_INITIAL_GUESSES
+void sample_all_roots(Context* ctx, const Equation* const* eqs, int num_equations, double x_val, 
+                      double* roots) {
+    for (int e = 0; e < num_equations; e++) {
+        double y_min, y_max;
+        get_seed_range(eqs[e], &y_min, &y_max);
+        sample_roots(ctx, eqs[e], x_val, y_min, y_max, roots + e * NUM_INITIAL_GUESSES);
+    }
+}
+
+// sample_all_roots in single precision for views that pass view_fits_float; roots
+// are placed to FLOAT_ROW_TOLERANCE of a row rather than to EPSILON
+void sample_all_roots_float(Context* ctx, const Equation* const* eqs, int num_equations, 
+                            double x_val, PlotSettings settings, double* roots) {
+    double tolerance = FLOAT_ROW_TOLERANCE / (5.0 * settings.zoom);
+    for (int e = 0; e < num_equations; e++) {
+        const Equation* eq = eqs[e];
+        double* eq_roots = roots + e * NUM_INITIAL_GUESSES;
+        if (eq->residual.length < 0 || eq->kind != EQUATION_IMPLICIT) {
+            sample_all_roots(ctx, &eqs[e], 1, x_val, eq_roots);
+            continue;
+        }
+
+        double y_min, y_max, initial_y[NUM_INITIAL_GUESSES];
+        int iterations[NUM_INITIAL_GUESSES];
+        get_seed_range(eq, &y_min, &y_max);
+        for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+            initial_y[k] = y_min + (y_max - y_min) * k / (NUM_INITIAL_GUESSES - 1);
+        }
+        int rechecks = solve_seeds_float(eq, x_val, initial_y, eq_roots, iterations, 
+                                         NUM_INITIAL_GUESSES, tolerance);
+        STATS_ADD(ctx, float_rechecks, rechecks);
+        for (int k = 0; k < NUM_INITIAL_GUESSES; k++) stats_record_solve(ctx, iterations[k]);
+    }
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Newton's method on the row offset dy from the view centre, with the residual in
+// double-double. Returns 0 and the offset on convergence, -1 otherwise.
+static int refine_root_deep(const Equation* eq, DoubleDouble x, DoubleDouble y_centre, 
+                            double row_height, double* dy) {
+    double h = row_height * 1e-3;
+    for (int iter = 0; iter < DEEP_REFINE_ITER; iter++) {
+        DoubleDouble y = dd_add_d(y_centre, *dy);
+        DoubleDouble f = program_eval_dd(&eq->residual, x, y);
+        DoubleDouble f_h = program_eval_dd(&eq->residual, x, dd_add_d(y, h));
+        double df = dd_sub(f_h, f).hi / h;
+        if (!isfinite(f.hi) || !isfinite(df) || df == 0) return -1;
+
+        double step = f.hi / df;
+        *dy -= step;
+        if (fabs(step) < row_height * 1e-6) return 0;
+    }
+    return -1;
+}
+
+// Deep-zoom counterpart of sample_roots: roots come back as offsets from the view's
+// y centre. Double-precision roots from the usual seeds locate the curve, and the
+// ones near the view are refined in double-double at the exact x.
+static void sample_roots_deep(Context* ctx, const Equation* eq, DoubleDouble x, 
+                              PlotSettings settings, double* offsets) {
+    double roots[NUM_INITIAL_GUESSES], candidates[NUM_INITIAL_GUESSES];
+    double y_min, y_max;
+    get_seed_range(eq, &y_min, &y_max);
+    sample_roots(ctx, eq, x.hi, y_min, y_max, roots);
+
+    DoubleDouble y_centre = {settings.y_offset, settings.y_offset_lo};
+    double row_height = 1.0 / (5.0 * settings.zoom);
+    // Double roots are only good to about the solver's step tolerance
+    double slack = 1e-8 * (1 + fabs(y_centre.hi));
+    int num_candidates = 0;
+    for (int k = 0; k < NUM_INITIAL_GUESSES; k++) {
+        if (!isfinite(roots[k])) continue;
+        double dy = (roots[k] - y_centre.hi) - y_centre.lo;
+        if (fabs(dy) <= GRID_HEIGHT / 2 * row_height + slack) candidates[num_candidates++] = dy;
+    }
+    qsort(candidates, num_candidates, sizeof(double), compare_doubles);
+
+    int count = 0;
+    for (int c = 0; c < num_candidates; c++) {
+        if (c > 0 && candidates[c] - candidates[c - 1] < slack) continue;
+        double dy = candidates[c];
+        if (refine_root_deep(eq, x, y_centre, row_height, &dy) != 0) continue;
+
+        int duplicate = 0;
+        for (int k = 0; k < count; k++) duplicate |= fabs(offsets[k] - dy) < row_height * 1e-3;
+        if (!duplicate) offsets[count++] = dy;
+    }
+    for (int k = count; k < NUM_INITIAL_GUESSES; k++) offsets[k] = NAN;
+}
+
+// sample_all_roots for views past double precision; x is the exact sample position
+void sample_all_roots_deep(Context* ctx, const Equation* const* eqs, int num_equations, 
+                           DoubleDouble x_val, PlotSettings settings, double* offsets) {
+    for (int e = 0; e < num_equations; e++) {
+        sample_roots_deep(ctx, eqs[e], x_val, settings, offsets + e * NUM_INITIAL_GUESSES);
+    }
+}
+
+// Sort the finite roots and merge any closer than tolerance; returns the count kept
+int collect_distinct_roots(const double* roots, int num_roots, double tolerance, double* distinct) {
+    int count = 0;
+    for (int k = 0; k < num_roots; k++) {
+        if (!isnan(roots[k]) && !isinf(roots[k])) distinct[count++] = roots[k];
+    }
+    qsort(distinct, count, sizeof(double), compare_doubles);
+
+    int kept = 0;
+    for (int k = 0; k < count; k++) {
+        if (kept == 0 || distinct[k] - distinct[kept - 1] > tolerance) {
+            distinct[kept++] = distinct[k];
+        }
+    }
+    return kept;
+}
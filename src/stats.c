@@ -0,0 +1,79 @@
+// Per-frame instrumentation: stage timers, solver counters and the iteration histogram
+#include "graphcalc_internal.h"
+
+#ifdef GRAPHCALC_STATS
+#include <time.h>
+
+double stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Record one finished solve: counters plus its histogram bucket
+void stats_record_solve(Context* ctx, int iterations) {
+    if (!ctx) return;
+    STATS_ADD(ctx, newton_iterations, iterations);
+    STATS_ADD(ctx, residual_evaluations, 2 * iterations);
+    if (iterations >= MAX_ITER) {
+        STATS_ADD(ctx, max_iter_failures, 1);
+    } else {
+        STATS_ADD(ctx, iteration_histogram[iterations * STATS_HISTOGRAM_BUCKETS / MAX_ITER], 1);
+    }
+}
+#endif
+
+void stats_reset(Context* ctx) {
+    if (ctx) memset(&ctx->stats, 0, sizeof(ctx->stats));
+}
+
+// Print the summary for the frame(s) since the last reset; -1 if stats are compiled out
+int stats_print(const Context* ctx, FILE* out) {
+#ifdef GRAPHCALC_STATS
+    static const char* stage_names[NUM_STAGES] = {"parse", "solve", "rasterize", "emit"};
+    if (!ctx) return -1;
+    const FrameStats* st = &ctx->stats;
+
+    fprintf(out, "\nFrame stats:");
+    for (int s = 0; s < NUM_STAGES; s++) {
+        fprintf(out, " %s %.3f ms%s", stage_names[s], st->stage_seconds[s] * 1e3, 
+                s + 1 < NUM_STAGES ? "," : "\n");
+    }
+    fprintf(out, "  residual evaluations %llu, Newton iterations %llu, MAX_ITER failures %llu\n", 
+            (unsigned long long)st->residual_evaluations, (unsigned long long)st->newton_iterations, 
+            (unsigned long long)st->max_iter_failures);
+    fprintf(out, "  roots found %llu, distinct %llu (%llu duplicates merged), float re-checks %llu\n", 
+            (unsigned long long)st->roots_found, (unsigned long long)st->roots_distinct, 
+            (unsigned long long)(st->roots_found - st->roots_distinct), 
+            (unsigned long long)st->float_rechecks);
+    fprintf(out, "  x samples %llu, parametric points %llu, continuity projections %llu\n", 
+            (unsigned long long)st->x_samples, (unsigned long long)st->parametric_points, 
+            (unsigned long long)st->continuity_projections);
+    fprintf(out, "  region tiles %llu, region cells evaluated %llu, contour samples %llu\n", 
+            (unsigned long long)st->region_tiles, (unsigned long long)st->region_cells, 
+            (unsigned long long)st->contour_samples);
+    fprintf(out, "  heat map samples %llu\n", (unsigned long long)st->heat_samples);
+
+    uint64_t largest = st->max_iter_failures;
+    for (int b = 0; b < STATS_HISTOGRAM_BUCKETS; b++) {
+        if (st->iteration_histogram[b] > largest) largest = st->iteration_histogram[b];
+    }
+    if (largest == 0) return 0;
+
+    fprintf(out, "  Newton iterations per solve:\n");
+    int width = MAX_ITER / STATS_HISTOGRAM_BUCKETS;
+    for (int b = 0; b <= STATS_HISTOGRAM_BUCKETS; b++) {
+        uint64_t count = b < STATS_HISTOGRAM_BUCKETS ? st->iteration_histogram[b] : st->max_iter_failures;
+        if (b < STATS_HISTOGRAM_BUCKETS) fprintf(out, "    %3d-%-3d ", b * width, (b + 1) * width - 1);
+        else fprintf(out, "    failed  ");
+        int bar = (int)(count * 40 / largest);
+        for (int i = 0; i < bar; i++) fputc('#', out);
+        fprintf(out, " %llu\n", (unsigned long long)count);
+    }
+    return 0;
+#else
+    (void)ctx;
+    (void)out;
+    return -1;
+#endif
+}
@@ -0,0 +1,251 @@
+// SVG export of traced curve branches
+#include "graphcalc_internal.h"
+
+// Growable list of points making up one curve branch
+typedef struct {
+    double* x;
+    double* y;
+    int count;
+    int capacity;
+} Polyline;
+
+static int polyline_append(Polyline* line, double x, double y) {
+    if (line->count == line->capacity) {
+        int capacity = line->capacity ? line->capacity * 2 : 64;
+        double* new_x = realloc(line->x, capacity * sizeof(double));
+        if (!new_x) return -1;
+        line->x = new_x;
+        double* new_y = realloc(line->y, capacity * sizeof(double));
+        if (!new_y) return -1;
+        line->y = new_y;
+        line->capacity = capacity;
+    }
+    line->x[line->count] = x;
+    line->y[line->count] = y;
+    line->count++;
+    return 0;
+}
+
+// Douglas-Peucker simplification; marks the points to keep and returns how many
+static int simplify_polyline(const Polyline* line, double tolerance, unsigned char* keep) {
+    if (line->count == 0) return 0;
+    memset(keep, 0, line->count);
+    keep[0] = keep[line->count - 1] = 1;
+    if (line->count < 3) return line->count;
+
+    // Explicit stack of [first, last] ranges instead of recursion
+    int* stack = malloc(2 * line->count * sizeof(int));
+    if (!stack) {
+        memset(keep, 1, line->count);
+        return line->count;
+    }
+    int top = 0;
+    stack[top++] = 0;
+    stack[top++] = line->count - 1;
+
+    while (top > 0) {
+        int last = stack[--top];
+        int first = stack[--top];
+        double ax = line->x[first], ay = line->y[first];
+        double dx = line->x[last] - ax, dy = line->y[last] - ay;
+        double length = sqrt(dx * dx + dy * dy);
+
+        int farthest = -1;
+        double max_dist = tolerance;
+        for (int i = first + 1; i < last; i++) {
+            double px = line->x[i] - ax, py = line->y[i] - ay;
+            double dist = length > 0 ? fabs(px * dy - py * dx) / length : sqrt(px * px + py * py);
+            if (dist > max_dist) {
+                max_dist = dist;
+                farthest = i;
+            }
+        }
+
+        if (farthest >= 0) {
+            keep[farthest] = 1;
+            stack[top++] = first;
+            stack[top++] = farthest;
+            stack[top++] = farthest;
+            stack[top++] = last;
+        }
+    }
+    free(stack);
+
+    int kept = 0;
+    for (int i = 0; i < line->count; i++) kept += keep[i];
+    return kept;
+}
+
+// Simplify a finished branch (already in pixel coordinates) and write it as an SVG path
+static int emit_svg_branch(FILE* out, const Polyline* line, int curve, double tolerance) {
+    unsigned char* keep = malloc(line->count);
+    if (!keep) return -1;
+    simplify_polyline(line, tolerance, keep);
+
+    fprintf(out, "<path class=\"c%d\" d=\"", curve);
+    int first = 1;
+    for (int i = 0; i < line->count; i++) {
+        if (!keep[i]) continue;
+        fprintf(out, "%c%.2f %.2f", first ? 'M' : 'L', line->x[i], line->y[i]);
+        first = 0;
+    }
+    // A lone root still shows up as a dot thanks to round line caps
+    if (line->count == 1) fprintf(out, "h0");
+    fprintf(out, "\"/>\n");
+    free(keep);
+    return 0;
+}
+
+// Open branches of one curve while it is being traced
+typedef struct {
+    Polyline open[NUM_INITIAL_GUESSES];
+    int num_open;
+} BranchSet;
+
+// Extend a curve's branches with the roots (as pixel rows) found at column px.
+// Each open branch continues with the nearest root within max_gap pixels of its
+// linear prediction; unmatched branches are written out, unmatched roots start new ones.
+static int advance_branches(BranchSet* set, FILE* out, int curve, 
+                            const double* rows, int num_roots, double px, double max_gap) {
+    int root_branch[NUM_INITIAL_GUESSES], branch_taken[NUM_INITIAL_GUESSES];
+    int status = 0;
+
+    // Greedily pair branches with roots, closest pairs first
+    for (int r = 0; r < num_roots; r++) root_branch[r] = -1;
+    for (int b = 0; b < set->num_open; b++) branch_taken[b] = 0;
+    while (1) {
+        int best_b = -1, best_r = -1;
+        double best_dist = max_gap;
+        for (int b = 0; b < set->num_open; b++) {
+            if (branch_taken[b]) continue;
+            const Polyline* line = &set->open[b];
+            int n = line->count;
+            double predicted = line->y[n - 1];
+            if (n >= 2) predicted += line->y[n - 1] - line->y[n - 2];
+            for (int r = 0; r < num_roots; r++) {
+                if (root_branch[r] >= 0) continue;
+                double dist = fabs(rows[r] - predicted);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best_b = b;
+                    best_r = r;
+                }
+            }
+        }
+        if (best_b < 0) break;
+        root_branch[best_r] = best_b;
+        branch_taken[best_b] = 1;
+    }
+
+    // Branches without a root end here; the rest keep their order
+    int slot[NUM_INITIAL_GUESSES];
+    int num_next = 0;
+    for (int b = 0; b < set->num_open; b++) {
+        if (branch_taken[b]) {
+            slot[b] = num_next;
+            set->open[num_next++] = set->open[b];
+        } else {
+            slot[b] = -1;
+            if (emit_svg_branch(out, &set->open[b], curve, SVG_TOLERANCE_PX) != 0) status = -1;
+            free(set->open[b].x);
+            free(set->open[b].y);
+        }
+    }
+
+    for (int r = 0; r < num_roots; r++) {
+        Polyline* line;
+        if (root_branch[r] >= 0) {
+            line = &set->open[slot[root_branch[r]]];
+        } else {
+            line = &set->open[num_next++];
+            memset(line, 0, sizeof(*line));
+        }
+        if (polyline_append(line, px, rows[r]) != 0) status = -1;
+    }
+    set->num_open = num_next;
+    return status;
+}
+
+// Export the current view as SVG, one path per traced branch and one colour class per
+// curve. Distinct roots near the canvas are linked into branches as x advances (see
+// advance_branches), so the output grows with the visible curve only. Sampling density is that of the character grid, so only the Douglas-Peucker
+// tolerance depends on the output size.
+int export_svg(const Equation* const* eqs, int num_equations, PlotSettings settings, 
+               const char* filename, int width, int height) {
+    if (width <= 0 || height <= 0) return -1;
+
+    BranchSet* sets = calloc(num_equations, sizeof(BranchSet));
+    if (!sets) return -1;
+
+    FILE* out = fopen(filename, "w");
+    if (!out) {
+        free(sets);
+        return -1;
+    }
+
+    double units_per_px = GRID_WIDTH / (5.0 * settings.zoom) / width;
+    double max_gap = SVG_BRANCH_GAP * width / (double)GRID_WIDTH;
+    double axis_x = width / 2.0 - settings.x_offset / units_per_px;
+    double axis_y = height / 2.0 + settings.y_offset / units_per_px;
+
+    fprintf(out, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" "
+                 "viewBox=\"0 0 %d %d\">\n", width, height, width, height);
+    fprintf(out, "<style>path{fill:none;stroke-width:1.5;stroke-linecap:round;"
+                 "stroke-linejoin:round}\n");
+    for (int e = 0; e < num_equations; e++) {
+        const unsigned char* rgb = RGB_CURVE_COLORS[e % NUM_CURVE_COLORS];
+        fprintf(out, ".c%d{stroke:#%02x%02x%02x}\n", e, rgb[0], rgb[1], rgb[2]);
+    }
+    fprintf(out, "</style>\n");
+    fprintf(out, "<rect width=\"100%%\" height=\"100%%\" fill=\"#ffffff\"/>\n");
+    fprintf(out, "<path style=\"stroke:#a0a0a0;stroke-width:1\" d=\"M0 %.2fH%dM%.2f 0V%d\"/>\n", 
+            axis_y, width, axis_x, height);
+
+    int status = 0;
+    int num_samples = GRID_WIDTH * POINTS_PER_COLUMN;
+    for (int s = 0; s < num_samples && status == 0; s++) {
+        double x_val = (s - num_samples / 2.0) / POINTS_PER_COLUMN / (5.0 * settings.zoom) 
+                       + settings.x_offset;
+        double px = width / 2.0 + (x_val - settings.x_offset) / units_per_px;
+
+        double roots[MAX_EQUATIONS * NUM_INITIAL_GUESSES];
+        sample_all_roots(NULL, eqs, num_equations, x_val, roots);
+
+        for (int e = 0; e < num_equations; e++) {
+            double rows[NUM_INITIAL_GUESSES];
+            int num_distinct = collect_distinct_roots(roots + e * NUM_INITIAL_GUESSES, 
+                                                      NUM_INITIAL_GUESSES, units_per_px, rows);
+
+            // Roots more than one branch gap off the canvas can't link to a visible point,
+            // so they are dropped and branches end just past the edge they leave by
+            int num_roots = 0;
+            for (int r = 0; r < num_distinct; r++) {
+                double row = height / 2.0 - (rows[r] - settings.y_offset) / units_per_px;
+                if (row >= -max_gap && row <= height + max_gap) rows[num_roots++] = row;
+            }
+            // Pixel rows run downwards, so reverse to keep them sorted
+            for (int r = 0; r < num_roots / 2; r++) {
+                double tmp = rows[r];
+                rows[r] = rows[num_roots - 1 - r];
+                rows[num_roots - 1 - r] = tmp;
+            }
+            if (advance_branches(&sets[e], out, e, rows, num_roots, px, max_gap) != 0) status = -1;
+        }
+    }
+
+    // Whatever is still open ends at the right edge
+    for (int e = 0; e < num_equations; e++) {
+        for (int b = 0; b < sets[e].num_open; b++) {
+            if (status == 0 && emit_svg_branch(out, &sets[e].open[b], e, SVG_TOLERANCE_PX) != 0) {
+                status = -1;
+            }
+            free(sets[e].open[b].x);
+            free(sets[e].open[b].y);
+        }
+    }
+    free(sets);
+
+    fprintf(out, "</svg>\n");
+    if (fclose(out) != 0) status = -1;
+    return status;
+}
@@ -0,0 +1,176 @@
+// Session symbols: named parameters and one-argument user functions. Names are
+// looked up once, when an equation is compiled; parameters then become slot
+// references and function calls are inlined, so evaluation never sees a name.
+#include "graphcalc_internal.h"
+
+// Names with a meaning of their own in equations
+static int is_reserved(const char* name) {
+    static const char* const reserved[] = {"x", "y", "r", "t", "theta", "pi"};
+    for (size_t i = 0; i < sizeof(reserved) / sizeof(reserved[0]); i++) {
+        if (strcmp(name, reserved[i]) == 0) return 1;
+    }
+    return is_function(name);
+}
+
+static Symbol* find_symbol(const SymbolTable* table, const char* name) {
+    for (int i = 0; i < table->count; i++) {
+        if (strcmp(table->symbols[i].name, name) == 0) return (Symbol*)&table->symbols[i];
+    }
+    return NULL;
+}
+
+// Value slot of a parameter, or NULL if name is not one
+double* parameter_slot(SymbolTable* table, const char* name) {
+    Symbol* symbol = find_symbol(table, name);
+    return symbol && !symbol->is_function ? &symbol->value : NULL;
+}
+
+// Read a name, as the tokenizer would, and skip the spaces around it
+static const char* read_name(const char* c, char* name, size_t size) {
+    size_t length = 0;
+    while (isspace((unsigned char)*c)) c++;
+    for (; isalpha((unsigned char)*c); c++) {
+        if (length + 1 < size) name[length++] = *c;
+    }
+    name[length] = '\0';
+    while (isspace((unsigned char)*c)) c++;
+    return c;
+}
+
+static int push_token(Token* out, int* count, const Token* token) {
+    if (*count >= MAX_TOKENS) return -1;
+    out[(*count)++] = *token;
+    return 0;
+}
+
+// Resolve session symbols in tokens, in place: parameter names become slot references
+// and each call of a user function is replaced by its body in parentheses, with the
+// argument substituted in parentheses too. Names equal to keep, a function's own
+// argument, are left alone. Returns the new count, or -1 when the expansion would not
+// fit in MAX_TOKENS.
+int resolve_symbols(const SymbolTable* table, Token* tokens, int num_tokens, const char* keep) {
+    static const Token open = {TOKEN_LPAREN, "(", 0, NULL}, close = {TOKEN_RPAREN, ")", 0, NULL};
+    if (!table) return num_tokens;
+    Token out[MAX_TOKENS];
+    int count = 0;
+
+    for (int i = 0; i < num_tokens; i++) {
+        const Symbol* symbol = NULL;
+        if (tokens[i].type == TOKEN_VARIABLE && !(keep && strcmp(tokens[i].str, keep) == 0)) {
+            symbol = find_symbol(table, tokens[i].str);
+        }
+        if (symbol && !symbol->is_function) {
+            Token parameter = tokens[i];
+            parameter.type = TOKEN_PARAMETER;
+            parameter.slot = &symbol->value;
+            if (push_token(out, &count, &parameter) != 0) return -1;
+            continue;
+        }
+
+        // A call needs its parenthesized argument; anything else is copied as it is
+        int close_at = -1;
+        if (symbol && i + 1 < num_tokens && tokens[i + 1].type == TOKEN_LPAREN) {
+            for (int j = i + 1, depth = 0; j < num_tokens && close_at < 0; j++) {
+                depth += tokens[j].type == TOKEN_LPAREN;
+                depth -= tokens[j].type == TOKEN_RPAREN;
+                if (depth == 0) close_at = j;
+            }
+        }
+        if (close_at < 0) {
+            if (push_token(out, &count, &tokens[i]) != 0) return -1;
+            continue;
+        }
+
+        Token argument[MAX_TOKENS];
+        int argument_count = close_at - i - 2;
+        memcpy(argument, tokens + i + 2, argument_count * sizeof(Token));
+        argument_count = resolve_symbols(table, argument, argument_count, keep);
+        if (argument_count < 0 || push_token(out, &count, &open) != 0) return -1;
+        for (int b = 0; b < symbol->body_num_tokens; b++) {
+            const Token* token = &symbol->body[b];
+            if (token->type != TOKEN_VARIABLE || strcmp(token->str, symbol->argument) != 0) {
+                if (push_token(out, &count, token) != 0) return -1;
+                continue;
+            }
+            if (push_token(out, &count, &open) != 0) return -1;
+            for (int a = 0; a < argument_count; a++) {
+                if (push_token(out, &count, &argument[a]) != 0) return -1;
+            }
+            if (push_token(out, &count, &close) != 0) return -1;
+        }
+        if (push_token(out, &count, &close) != 0) return -1;
+        i = close_at;
+    }
+
+    memcpy(tokens, out, count * sizeof(Token));
+    return count;
+}
+
+// Tokenize expr and resolve its symbols. An expansion too long to hold leaves the
+// expression undefined, so nothing is drawn rather than a truncated curve.
+int tokenize_resolved(const SymbolTable* table, const char* expr, Token* tokens) {
+    int num_tokens = resolve_symbols(table, tokens, tokenize_expression(expr, tokens), NULL);
+    if (num_tokens >= 0) return num_tokens;
+    tokens[0] = (Token){TOKEN_NUMBER, "nan", NAN, NULL};
+    return 1;
+}
+
+// Turn every variable other than first and second (second may be NULL) into NaN, so an
+// undefined name draws nothing instead of reading as 0. The first such name is copied
+// to undefined when it is still empty.
+void mark_undefined(Token* tokens, int num_tokens, const char* first, const char* second, 
+                    char* undefined) {
+    for (int i = 0; i < num_tokens; i++) {
+        if (tokens[i].type != TOKEN_VARIABLE || strcmp(tokens[i].str, first) == 0) continue;
+        if (second && strcmp(tokens[i].str, second) == 0) continue;
+        if (!undefined[0]) strcpy(undefined, tokens[i].str);
+        tokens[i] = (Token){TOKEN_NUMBER, "nan", NAN, NULL};
+    }
+}
+
+// Define or update a symbol from "name = expression" or "name(argument) = expression".
+// A parameter's expression must be constant; a function's may also read x and y.
+// Returns 1 once stored, 0 when text is not a definition (an equation such as
+// "a = x", or a reserved name) and -1 when it is one that cannot be stored.
+int define_symbol(SymbolTable* table, const char* text) {
+    char name[sizeof(table->symbols[0].name)], argument[sizeof(table->symbols[0].argument)] = "";
+    const char* c = read_name(text, name, sizeof(name));
+    if (*c == '(') {
+        c = read_name(c + 1, argument, sizeof(argument));
+        if (!argument[0] || *c != ')') return 0;
+        c++;
+        while (isspace((unsigned char)*c)) c++;
+    }
+    if (!name[0] || *c != '=' || is_reserved(name) || strpbrk(c, "<>,") || strstr(c, "..")) return 0;
+
+    Token body[MAX_TOKENS];
+    int num_tokens = tokenize_expression(c + 1, body);
+    num_tokens = resolve_symbols(table, body, num_tokens, argument[0] ? argument : NULL);
+    if (num_tokens <= 0) return -1;
+    for (int i = 0; i < num_tokens; i++) {
+        if (body[i].type != TOKEN_VARIABLE) continue;
+        int plain = strcmp(body[i].str, "x") == 0 || strcmp(body[i].str, "y") == 0;
+        if (plain && !argument[0]) return 0;
+        if (!plain && strcmp(body[i].str, argument) != 0) return -1;  // Undefined name
+    }
+
+    double value = 0;
+    if (!argument[0]) {
+        value = evaluate_expression(body, num_tokens, 0, 0);
+        if (!isfinite(value)) return -1;
+    }
+    Symbol* symbol = find_symbol(table, name);
+    if (!symbol) {
+        if (table->count >= MAX_SYMBOLS) return -1;
+        symbol = &table->symbols[table->count++];
+        strcpy(symbol->name, name);
+    }
+
+    // Updating a parameter keeps its slot, so equations already compiled see the new value
+    symbol->is_function = argument[0] != '\0';
+    symbol->value = value;
+    strcpy(symbol->argument, argument);
+    symbol->body_num_tokens = symbol->is_function ? num_tokens : 0;
+    memcpy(symbol->body, body, symbol->body_num_tokens * sizeof(Token));
+    return 1;
+}
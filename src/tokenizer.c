@@ -0,0 +1,104 @@
+// Tokenizer: splits expression text into numbers, variables, functions and operators
+#include "graphcalc_internal.h"
+
+// Utility functions for token handling
+int is_operator(char c) {
+    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '^');
+}
+
+int is_function(const char* str) {
+    return (strcmp(str, "sin") == 0 || strcmp(str, "cos") == 0 || 
+            strcmp(str, "tan") == 0 || strcmp(str, "log") == 0 || 
+            strcmp(str, "ln") == 0 || strcmp(str, "exp") == 0 || 
+            strcmp(str, "atan") == 0);
+}
+
+int get_precedence(char op) {
+    switch (op) {
+        case '^': return 3;
+        case '*': case '/': return 2;
+        case '+': case '-': return 1;
+        default: return 0;
+    }
+}
+
+// Enhanced tokenizer
+int tokenize_expression(const char* expr, Token* tokens) {
+    int num_tokens = 0;
+    int i = 0;
+    char buffer[32];
+    int buf_pos;
+
+    while (expr[i]) {
+        // Skip whitespace
+        while (isspace(expr[i])) i++;
+        if (!expr[i]) break;
+
+        Token* token = &tokens[num_tokens];
+        
+        if (isdigit(expr[i]) || expr[i] == '.') {
+            // Parse number
+            buf_pos = 0;
+            while (isdigit(expr[i]) || expr[i] == '.') {
+                buffer[buf_pos++] = expr[i++];
+            }
+            buffer[buf_pos] = '\0';
+            token->type = TOKEN_NUMBER;
+            token->value = atof(buffer);
+            strcpy(token->str, buffer);
+            num_tokens++;
+        }
+        else if (isalpha(expr[i])) {
+            // Parse variable or function
+            buf_pos = 0;
+            while (isalpha(expr[i])) {
+                buffer[buf_pos++] = expr[i++];
+            }
+            buffer[buf_pos] = '\0';
+
+            if (is_function(buffer)) {
+                token->type = TOKEN_FUNCTION;
+            } else if (strcmp(buffer, "pi") == 0) {
+                // Named constant, so angle ranges can be written as multiples of pi
+                token->type = TOKEN_NUMBER;
+                token->value = PI;
+            } else {
+                token->type = TOKEN_VARIABLE;
+            }
+            strcpy(token->str, buffer);
+            num_tokens++;
+        }
+        else if (expr[i] == '=') {
+            token->type = TOKEN_EQUALS;
+            token->str[0] = '=';
+            token->str[1] = '\0';
+            i++;
+            num_tokens++;
+        }
+        else if (expr[i] == '(') {
+            token->type = TOKEN_LPAREN;
+            token->str[0] = '(';
+            token->str[1] = '\0';
+            i++;
+            num_tokens++;
+        }
+        else if (expr[i] == ')') {
+            token->type = TOKEN_RPAREN;
+            token->str[0] = ')';
+            token->str[1] = '\0';
+            i++;
+            num_tokens++;
+        }
+        else if (is_operator(expr[i])) {
+            token->type = TOKEN_OPERATOR;
+            token->str[0] = expr[i];
+            token->str[1] = '\0';
+            i++;
+            num_tokens++;
+        }
+        else {
+            i++; // Skip unrecognized characters
+        }
+    }
+    return num_tokens;
+}
@@ -0,0 +1,649 @@
+// Regression tests for the public API: equation compilation and definitions, rendered
+// frames (curves, regions, contours, traced curves, poles, overlays and deep zoom),
+// root and intersection values, exports, animation and kernel selection. Prints one
+// line per failed check and exits non-zero if any failed.
+#include "graphcalc.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_TOLERANCE 1e-9
+
+static int failures;
+static int checks;
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, tol) check(fabs((a) - (b)) <= (tol), #a " ~ " #b, __FILE__, __LINE__)
+
+static void check(int ok, const char* what, const char* file, int line) {
+    checks++;
+    if (!ok) {
+        failures++;
+        printf("%s:%d: check failed: %s\n", file, line, what);
+    }
+}
+
+// Scratch file in the working directory, removed by each test
+static void temp_path(char* path, size_t size, const char* suffix) {
+    snprintf(path, size, "graphcalc-test%s", suffix);
+}
+
+static uint64_t load_le(const unsigned char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static double load_le_double(const unsigned char* p) {
+    uint64_t bits = load_le(p, 8);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+static void test_compile(gc_context* ctx) {
+    gc_equation* eq = gc_equation_compile(ctx, "x^2 + y^2 = 25");
+    CHECK(eq != NULL);
+    if (!eq) return;
+    CHECK(strcmp(gc_equation_text(eq), "x^2 + y^2 = 25") == 0);
+    CHECK_NEAR(gc_equation_residual(eq, 3, 4), 0.0, TEST_TOLERANCE);
+    CHECK_NEAR(gc_equation_residual(eq, 1, 2), -20.0, TEST_TOLERANCE);
+    gc_equation_free(eq);
+
+    // A missing '=' means "= 0"
+    eq = gc_equation_compile(ctx, "sin(x) - y");
+    CHECK(eq != NULL);
+    if (!eq) return;
+    CHECK_NEAR(gc_equation_residual(eq, 0.5, 0), sin(0.5), TEST_TOLERANCE);
+    gc_equation_free(eq);
+}
+
+static void test_definitions(gc_context* ctx) {
+    CHECK(gc_define(ctx, "a = 2") == 1);
+    CHECK(gc_define(ctx, "f(t) = t^2 + 1") == 1);
+    CHECK(gc_define(ctx, "y = x") == 0);
+
+    gc_equation* eq = gc_equation_compile(ctx, "y = a*f(x)");
+    CHECK(eq != NULL);
+    if (!eq) return;
+    CHECK_NEAR(gc_equation_residual(eq, 1, 0), -4.0, TEST_TOLERANCE);
+
+    // Parameters are read through slots, so the compiled equation sees the update
+    CHECK(gc_context_set_parameter(ctx, "a", 3) == 0);
+    CHECK_NEAR(gc_equation_residual(eq, 1, 0), -6.0, TEST_TOLERANCE);
+    CHECK(gc_context_set_parameter(ctx, "missing", 1) == -1);
+    CHECK(gc_equation_undefined(eq) == NULL);
+    gc_equation_free(eq);
+
+    // An undefined name is reported and evaluates to NaN rather than 0
+    eq = gc_equation_compile(ctx, "y = k*x");
+    CHECK(eq != NULL);
+    if (!eq) return;
+    CHECK(gc_equation_undefined(eq) != NULL && strcmp(gc_equation_undefined(eq), "k") == 0);
+    CHECK(isnan(gc_equation_residual(eq, 1, 0)));
+    gc_equation_free(eq);
+}
+
+static void test_frame(gc_context* ctx) {
+    gc_equation* eq = gc_equation_compile(ctx, "y = x");
+    gc_frame* frame = gc_frame_create();
+    CHECK(eq != NULL && frame != NULL);
+    if (!eq || !frame) {
+        gc_equation_free(eq);
+        gc_frame_free(frame);
+        return;
+    }
+
+    const gc_equation* eqs[] = {eq};
+    gc_view view = {1.0, 0, 0, 0, 0};
+    CHECK(gc_frame_render(ctx, frame, eqs, 1, view, NULL, 0) == 0);
+
+    // Five cells per unit centred on the origin: (x, y) lands on row 10 - 5y, column
+    // 40 + 5x, so the diagonal runs one row up for every five columns
+    for (int k = -1; k <= 1; k += 2) {
+        CHECK(gc_frame_cell(frame, 10 - 5 * k, 40 + 5 * k) == '*');
+    }
+    // Axes through the centre, with a '+' tick on every even column and row
+    CHECK(gc_frame_cell(frame, 10, 5) == '-');
+    CHECK(gc_frame_cell(frame, 10, 6) == '+');
+    CHECK(gc_frame_cell(frame, 3, 40) == '|');
+    CHECK(gc_frame_cell(frame, 2, 5) == ' ');
+    CHECK(gc_frame_cell(frame, 18, 75) == ' ');
+
+    gc_frame_free(frame);
+    gc_equation_free(eq);
+}
+
+// Whether every glyph of the frame lies on y = f(x), give or take the join to the
+// next column for slopes up to 1, and there are at least min_cells of them. The
+// view's offset must be exact in a double.
+static int frame_follows(const gc_frame* frame, gc_view view, char glyph, double (*f)(double), 
+                         int min_cells) {
+    int cells = 0;
+    for (int col = 0; col < GC_GRID_WIDTH; col++) {
+        double x = view.x_offset + (col + 0.5 - GC_GRID_WIDTH / 2) / (5.0 * view.zoom);
+        double row = GC_GRID_HEIGHT / 2 - (f(x) - view.y_offset) * 5.0 * view.zoom;
+        for (int r = 0; r < GC_GRID_HEIGHT; r++) {
+            if (gc_frame_cell(frame, r, col) != glyph) continue;
+            if (fabs(r + 0.5 - row) > 2.5) return 0;
+            cells++;
+        }
+    }
+    return cells >= min_cells;
+}
+
+static double identity(double x) {
+    return x;
+}
+
+static double half(double x) {
+    return x / 2;
+}
+
+static double from_left_edge(double x) {
+    return x + GC_GRID_WIDTH / 2 / 5.0;
+}
+
+// Centre of a cell in view units at zoom 1 around the origin
+static double cell_x(int col) {
+    return (col + 0.5 - GC_GRID_WIDTH / 2) / 5.0;
+}
+
+static double cell_y(int row) {
+    return (GC_GRID_HEIGHT / 2 - row - 0.5) / 5.0;
+}
+
+// Compile text and render it alone in view; NULL on failure
+static gc_equation* render_alone(gc_context* ctx, gc_frame* frame, const char* text, gc_view view) {
+    gc_equation* eq = gc_equation_compile(ctx, text);
+    if (!eq) return NULL;
+    const gc_equation* eqs[] = {eq};
+    if (gc_frame_render(ctx, frame, eqs, 1, view, NULL, 0) != 0) {
+        gc_equation_free(eq);
+        return NULL;
+    }
+    return eq;
+}
+
+// Whether every cell holding glyph is within tolerance of the circle of the given
+// radius about the origin, and there are at least min_cells of them
+static int cells_on_circle(const gc_frame* frame, char glyph, double radius, double tolerance, 
+                           int min_cells) {
+    int cells = 0;
+    for (int row = 0; row < GC_GRID_HEIGHT; row++) {
+        for (int col = 0; col < GC_GRID_WIDTH; col++) {
+            if (gc_frame_cell(frame, row, col) != glyph) continue;
+            if (fabs(hypot(cell_x(col), cell_y(row)) - radius) > tolerance) return 0;
+            cells++;
+        }
+    }
+    return cells >= min_cells;
+}
+
+static void test_regions(gc_context* ctx) {
+    gc_frame* frame = gc_frame_create();
+    CHECK(frame != NULL);
+    if (!frame) return;
+    gc_view view = {1.0, 0, 0, 0, 0};
+
+    // Inside the circle is shaded wherever nothing else is drawn; outside never is
+    gc_equation* eq = render_alone(ctx, frame, "x^2 + y^2 < 4", view);
+    CHECK(eq != NULL);
+    int inside_shaded = 1, outside_clear = 1;
+    for (int row = 0; row < GC_GRID_HEIGHT && eq; row++) {
+        for (int col = 0; col < GC_GRID_WIDTH; col++) {
+            double r = hypot(cell_x(col), cell_y(row));
+            char cell = gc_frame_cell(frame, row, col);
+            if (r < 1.7 && col != GC_GRID_WIDTH / 2 && row != GC_GRID_HEIGHT / 2) {
+                inside_shaded &= cell == '.';
+            }
+            if (r > 2.3) outside_clear &= cell != '.';
+        }
+    }
+    CHECK(inside_shaded && outside_clear);
+    CHECK(cells_on_circle(frame, '*', 2, 0.3, 20));
+    gc_equation_free(eq);
+
+    eq = render_alone(ctx, frame, "x^2 + y^2 > 4", view);
+    CHECK(eq != NULL && gc_frame_cell(frame, 1, 5) == '.' && gc_frame_cell(frame, 9, 38) == ' ');
+    gc_equation_free(eq);
+
+    // Contours 1, 4, 7, 10, 13 and 16 of x^2 + y^2, drawn as '0' to '5'
+    eq = render_alone(ctx, frame, "x^2 + y^2 = 1..16, 6", view);
+    CHECK(eq != NULL);
+    for (int level = 0; level < 6 && eq; level++) {
+        CHECK(cells_on_circle(frame, (char)('0' + level), sqrt(1 + 3 * level), 0.3, 8));
+    }
+    gc_equation_free(eq);
+    gc_frame_free(frame);
+}
+
+static void test_traced_curves(gc_context* ctx) {
+    gc_frame* frame = gc_frame_create();
+    CHECK(frame != NULL);
+    if (!frame) return;
+    gc_view view = {1.0, 0, 0, 0, 0};
+
+    gc_equation* eq = render_alone(ctx, frame, "x = 2*cos(t), y = 2*sin(t)", view);
+    CHECK(eq != NULL && cells_on_circle(frame, '*', 2, 0.3, 40));
+    gc_equation_free(eq);
+
+    eq = render_alone(ctx, frame, "r = 1.5", view);
+    CHECK(eq != NULL && cells_on_circle(frame, '*', 1.5, 0.3, 30));
+    gc_equation_free(eq);
+
+    // Half a turn only: the left half of the circle stays empty
+    eq = render_alone(ctx, frame, "r = 1.5, theta = -pi/2..pi/2", view);
+    CHECK(eq != NULL && cells_on_circle(frame, '*', 1.5, 0.3, 15));
+    for (int row = 0; row < GC_GRID_HEIGHT && eq; row++) {
+        for (int col = 0; col < GC_GRID_WIDTH / 2 - 1; col++) {
+            if (gc_frame_cell(frame, row, col) == '*') CHECK(!"left half drawn");
+        }
+    }
+    gc_equation_free(eq);
+    gc_frame_free(frame);
+}
+
+static void test_poles(gc_context* ctx) {
+    gc_frame* frame = gc_frame_create();
+    CHECK(frame != NULL);
+    if (!frame) return;
+    gc_view view = {1.0, 0, 0, 0, 0};
+
+    // tan(x) runs through the origin, but the columns holding its poles at -+pi/2 are
+    // empty around y = 0: the branches are not joined across the poles
+    gc_equation* eq = render_alone(ctx, frame, "y = tan(x)", view);
+    CHECK(eq != NULL);
+    CHECK(gc_frame_cell(frame, 8, 41) == '*' && gc_frame_cell(frame, 11, 38) == '*');
+    int pole_cols[] = {(int)floor(GC_GRID_WIDTH / 2 - 5 * M_PI / 2), 
+                       (int)floor(GC_GRID_WIDTH / 2 + 5 * M_PI / 2)};
+    for (int p = 0; p < 2; p++) {
+        for (int row = GC_GRID_HEIGHT / 2 - 3; row <= GC_GRID_HEIGHT / 2 + 3; row++) {
+            CHECK(gc_frame_cell(frame, row, pole_cols[p]) != '*');
+        }
+    }
+    gc_equation_free(eq);
+    gc_frame_free(frame);
+}
+
+static const gc_marker* find_feature(const gc_marker* features, int count, char glyph, double x) {
+    for (int i = 0; i < count; i++) {
+        if (features[i].glyph == glyph && fabs(features[i].x - x) < 1e-6) return &features[i];
+    }
+    return NULL;
+}
+
+static void test_overlays(gc_context* ctx) {
+    gc_frame* frame = gc_frame_create();
+    CHECK(frame != NULL);
+    if (!frame) return;
+    gc_view view = {1.0, 0, 0, 0, 0};
+
+    // x^3 - 3x: zeros at 0 and -+sqrt(3), a maximum at (-1, 2), a minimum at (1, -2)
+    // and an inflection at the origin, all to full double precision. At zoom 1 the
+    // minimum would sit on the bottom edge, just out of view.
+    gc_view wide = {0.5, 0, 0, 0, 0};
+    gc_context_set_overlays(ctx, GC_OVERLAY_FEATURES);
+    gc_equation* eq = render_alone(ctx, frame, "y = x^3 - 3*x", wide);
+    CHECK(eq != NULL);
+    gc_marker features[32];
+    int count = eq ? gc_frame_features(frame, features, 32) : 0;
+    CHECK(count == 6);
+    const gc_marker* expected[] = {
+        find_feature(features, count, 'o', -sqrt(3)), find_feature(features, count, 'o', 0), 
+        find_feature(features, count, 'o', sqrt(3)), find_feature(features, count, '^', -1), 
+        find_feature(features, count, 'v', 1), find_feature(features, count, '~', 0)
+    };
+    double values[] = {0, 0, 0, 2, -2, 0};
+    for (int i = 0; i < 6; i++) {
+        CHECK(expected[i] != NULL);
+        if (expected[i]) CHECK_NEAR(expected[i]->y, values[i], TEST_TOLERANCE);
+    }
+    if (expected[3]) CHECK_NEAR(expected[3]->x, -1, TEST_TOLERANCE);
+    if (expected[4]) CHECK_NEAR(expected[4]->x, 1, TEST_TOLERANCE);
+    gc_equation_free(eq);
+
+    // f' of x^2 / 4 is x / 2, and the integral of 1 grows from 0 at the left edge
+    gc_context_set_overlays(ctx, GC_OVERLAY_DERIVATIVE | GC_OVERLAY_INTEGRAL);
+    eq = render_alone(ctx, frame, "y = x^2/4", view);
+    CHECK(eq != NULL && frame_follows(frame, view, '\'', half, 30));
+    gc_equation_free(eq);
+    eq = render_alone(ctx, frame, "y = 1", view);
+    CHECK(eq != NULL && frame_follows(frame, view, '"', from_left_edge, 8));
+    gc_equation_free(eq);
+
+    gc_context_set_overlays(ctx, 0);
+    gc_frame_free(frame);
+}
+
+// Views deep enough to defeat the double solver's tolerances, at an offset and at the
+// origin, where the offset alone never asks for double-double
+static void test_deep_zoom(gc_context* ctx) {
+    gc_equation* line = gc_equation_compile(ctx, "y = x");
+    gc_equation* wave = gc_equation_compile(ctx, "y = sin(x)");
+    gc_frame* frame = gc_frame_create();
+    FILE* out = tmpfile();
+    CHECK(line != NULL && wave != NULL && frame != NULL && out != NULL);
+    if (line && wave && frame && out) {
+        const gc_equation* lines[] = {line};
+        const gc_equation* waves[] = {wave};
+        gc_plot_options options = {0};
+        for (double zoom = 1e8; zoom <= 1e13; zoom *= 10) {
+            gc_view offset = {zoom, 1, 1, 0, 0};
+            gc_view origin = {zoom, 0, 0, 0, 0};
+            CHECK(gc_frame_render(ctx, frame, lines, 1, offset, NULL, 0) == 0);
+            CHECK(frame_follows(frame, offset, '*', identity, GC_GRID_HEIGHT));
+            CHECK(gc_frame_render(ctx, frame, lines, 1, origin, NULL, 0) == 0);
+            CHECK(frame_follows(frame, origin, '*', identity, GC_GRID_HEIGHT));
+            CHECK(gc_frame_render(ctx, frame, waves, 1, origin, NULL, 0) == 0);
+            CHECK(frame_follows(frame, origin, '*', sin, GC_GRID_HEIGHT));
+        }
+
+        // The footer names the arithmetic, so the switch itself is visible
+        gc_view shallow = {1e6, 0, 0, 0, 0}, deep = {1e10, 0, 0, 0, 0};
+        char text[8192];
+        for (int pass = 0; pass < 2; pass++) {
+            gc_view view = pass ? deep : shallow;
+            rewind(out);
+            CHECK(gc_frame_render(ctx, frame, lines, 1, view, NULL, 0) == 0);
+            gc_frame_print(ctx, frame, out, lines, 1, view, options, NULL, 0);
+            long length = ftell(out);
+            rewind(out);
+            size_t read = fread(text, 1, length < (long)sizeof(text) ? (size_t)length : sizeof(text) - 1, out);
+            text[read] = '\0';
+            CHECK((strstr(text, "double-double") != NULL) == pass);
+        }
+    }
+    if (out) fclose(out);
+    gc_frame_free(frame);
+    gc_equation_free(line);
+    gc_equation_free(wave);
+}
+
+static void test_roots(gc_context* ctx) {
+    gc_equation* circle = gc_equation_compile(ctx, "x^2 + y^2 = 1");
+    gc_equation* cubic = gc_equation_compile(ctx, "y = x^3 - 2*x");
+    CHECK(circle != NULL && cubic != NULL);
+    if (!circle || !cubic) {
+        gc_equation_free(circle);
+        gc_equation_free(cubic);
+        return;
+    }
+
+    double roots[16];
+    int count = gc_find_roots(ctx, circle, 0, roots, 16);
+    CHECK(count == 2);
+    if (count == 2) {
+        CHECK_NEAR(roots[0], -1.0, 1e-6);
+        CHECK_NEAR(roots[1], 1.0, 1e-6);
+    }
+    CHECK(gc_find_roots(ctx, circle, 2, roots, 16) == 0);
+
+    int iterations = -1;
+    double y = gc_solve(ctx, cubic, 2, 0, &iterations);
+    CHECK_NEAR(y, 4.0, 1e-6);
+    CHECK(iterations >= 0);
+
+    gc_equation_free(circle);
+    gc_equation_free(cubic);
+}
+
+static void test_intersections(gc_context* ctx) {
+    gc_equation* line = gc_equation_compile(ctx, "y = x");
+    gc_equation* circle = gc_equation_compile(ctx, "x^2 + y^2 = 2");
+    CHECK(line != NULL && circle != NULL);
+    if (!line || !circle) {
+        gc_equation_free(line);
+        gc_equation_free(circle);
+        return;
+    }
+
+    gc_view view = {1.0, 0, 0, 0, 0};
+    double xs[8], ys[8];
+    int count = gc_find_intersections(line, circle, view, xs, ys, 8);
+    CHECK(count == 2);
+    for (int i = 0; i < count && count == 2; i++) {
+        CHECK_NEAR(fabs(xs[i]), 1.0, 1e-6);
+        CHECK_NEAR(ys[i], xs[i], 1e-6);
+    }
+    if (count == 2) CHECK(xs[0] * xs[1] < 0);
+
+    gc_equation_free(line);
+    gc_equation_free(circle);
+}
+
+static void test_export_points(gc_context* ctx) {
+    gc_equation* eq = gc_equation_compile(ctx, "x^2 + y^2 = 4");
+    CHECK(eq != NULL);
+    if (!eq) return;
+    const gc_equation* eqs[] = {eq};
+    gc_view view = {1.0, 0, 0, 0, 0};
+    char path[64];
+
+    // Binary: header fields, then (x, y, curve) records that lie on the circle
+    temp_path(path, sizeof(path), ".bin");
+    CHECK(gc_export_points(eqs, 1, view, path, 64, 1) == 0);
+    FILE* in = fopen(path, "rb");
+    CHECK(in != NULL);
+    if (in) {
+        unsigned char header[32];
+        CHECK(fread(header, 1, sizeof(header), in) == sizeof(header));
+        CHECK(memcmp(header, "GCPT", 4) == 0);
+        CHECK(load_le(header + 4, 4) == 1);
+        CHECK(load_le(header + 8, 4) == sizeof(header));
+        CHECK(load_le(header + 12, 4) == 3);
+        uint64_t expected = load_le(header + 16, 8);
+        CHECK(expected > 0 && expected < 1000);
+
+        unsigned char record[24];
+        uint64_t records = 0;
+        while (fread(record, 1, sizeof(record), in) == sizeof(record)) {
+            double x = load_le_double(record);
+            double y = load_le_double(record + 8);
+            CHECK_NEAR(gc_equation_residual(eq, x, y), 0.0, 1e-6);
+            CHECK(load_le_double(record + 16) == 0.0);
+            records++;
+        }
+        CHECK(records == expected);
+        fclose(in);
+    }
+    remove(path);
+
+    // CSV: a header row, then "curve,x,y" rows on the circle
+    temp_path(path, sizeof(path), ".csv");
+    CHECK(gc_export_points(eqs, 1, view, path, 64, 0) == 0);
+    in = fopen(path, "r");
+    CHECK(in != NULL);
+    if (in) {
+        char line[128];
+        CHECK(fgets(line, sizeof(line), in) != NULL && strcmp(line, "curve,x,y\n") == 0);
+        int rows = 0, curve;
+        double x, y;
+        while (fscanf(in, "%d,%lf,%lf\n", &curve, &x, &y) == 3) {
+            CHECK(curve == 0);
+            CHECK_NEAR(gc_equation_residual(eq, x, y), 0.0, 1e-6);
+            rows++;
+        }
+        CHECK(rows > 0);
+        fclose(in);
+    }
+    remove(path);
+
+    gc_equation_free(eq);
+}
+
+static void test_export_images(gc_context* ctx) {
+    gc_equation* eq = gc_equation_compile(ctx, "y = sin(x)");
+    CHECK(eq != NULL);
+    if (!eq) return;
+    const gc_equation* eqs[] = {eq};
+    gc_view view = {1.0, 0, 0, 0, 0};
+    char path[64];
+
+    // PGM and PPM: the header gives the size and the pixel data fills the rest exactly
+    for (int channels = 1; channels <= 3; channels += 2) {
+        temp_path(path, sizeof(path), channels == 1 ? ".pgm" : ".ppm");
+        CHECK(gc_export_raster(eqs, 1, view, path, 160, 90, channels) == 0);
+        FILE* in = fopen(path, "rb");
+        CHECK(in != NULL);
+        if (in) {
+            int kind = 0, width = 0, height = 0, max_value = 0;
+            CHECK(fscanf(in, "P%d %d %d %d", &kind, &width, &height, &max_value) == 4);
+            CHECK(kind == (channels == 1 ? 5 : 6));
+            CHECK(width == 160 && height == 90 && max_value == 255);
+            fgetc(in);
+            long start = ftell(in);
+            fseek(in, 0, SEEK_END);
+            CHECK(ftell(in) - start == 160L * 90 * channels);
+            fclose(in);
+        }
+        remove(path);
+    }
+
+    gc_equation_free(eq);
+}
+
+// Curve paths (class "c0") of an SVG export: how many, and the bounds of their points
+typedef struct {
+    int paths;
+    double x_min, x_max, y_min, y_max;
+} SvgCurve;
+
+static int read_svg_curve(const char* path, SvgCurve* curve) {
+    static char text[1 << 16];
+    FILE* in = fopen(path, "r");
+    if (!in) return -1;
+    size_t length = fread(text, 1, sizeof(text) - 1, in);
+    fclose(in);
+    text[length] = '\0';
+    if (!strstr(text, "<svg")) return -1;
+
+    *curve = (SvgCurve){0, INFINITY, -INFINITY, INFINITY, -INFINITY};
+    for (const char* c = strstr(text, "class=\"c0\" d=\""); c; c = strstr(c, "class=\"c0\" d=\"")) {
+        c += strlen("class=\"c0\" d=\"");
+        curve->paths++;
+        double x, y;
+        int used;
+        while ((*c == 'M' || *c == 'L') && sscanf(c + 1, "%lf %lf%n", &x, &y, &used) == 2) {
+            curve->x_min = fmin(curve->x_min, x);
+            curve->x_max = fmax(curve->x_max, x);
+            curve->y_min = fmin(curve->y_min, y);
+            curve->y_max = fmax(curve->y_max, y);
+            c += 1 + used;
+        }
+    }
+    return 0;
+}
+
+static void test_export_svg(gc_context* ctx) {
+    gc_equation* wave = gc_equation_compile(ctx, "y = sin(x)");
+    gc_equation* poles = gc_equation_compile(ctx, "y = tan(x)");
+    CHECK(wave != NULL && poles != NULL);
+    if (!wave || !poles) {
+        gc_equation_free(wave);
+        gc_equation_free(poles);
+        return;
+    }
+    gc_view view = {1.0, 0, 0, 0, 0};
+    char path[64];
+    SvgCurve curve;
+    temp_path(path, sizeof(path), ".svg");
+
+    // sin(x) is one branch across the whole width, between rows 150 -+ 60 * sin
+    const gc_equation* waves[] = {wave};
+    CHECK(gc_export_svg(waves, 1, view, path, 400, 300) == 0);
+    CHECK(read_svg_curve(path, &curve) == 0);
+    CHECK(curve.paths == 1);
+    CHECK(curve.x_min < 5 && curve.x_max > 395);
+    CHECK(curve.y_min > 85 && curve.y_max < 215);
+
+    // tan(x) has five branches in view; roots far past the canvas are not traced
+    const gc_equation* tans[] = {poles};
+    CHECK(gc_export_svg(tans, 1, view, path, 800, 200) == 0);
+    CHECK(read_svg_curve(path, &curve) == 0);
+    CHECK(curve.paths >= 5 && curve.paths <= 10);
+    CHECK(curve.y_min >= -30 && curve.y_max <= 230);
+    remove(path);
+
+    gc_equation_free(wave);
+    gc_equation_free(poles);
+}
+
+static void test_animate(gc_context* ctx) {
+    gc_equation* eq = gc_equation_compile(ctx, "y = b*x");
+    FILE* out = tmpfile();
+    CHECK(eq != NULL && out != NULL);
+    if (!eq || !out) {
+        gc_equation_free(eq);
+        if (out) fclose(out);
+        return;
+    }
+    const gc_equation* eqs[] = {eq};
+    gc_view view = {1.0, 0, 0, 0, 0};
+    gc_plot_options options = {0};
+
+    // An undefined parameter and a failed animation are told apart
+    CHECK(gc_animate(ctx, eqs, 1, view, options, "b", 0, 1, 3, 1000, out) == -1);
+    CHECK(gc_define(ctx, "b = 1") == 1);
+    CHECK(gc_animate(ctx, eqs, 1, view, options, "b", 0, 1, 0, 1000, out) == -2);
+    gc_equation_free(eq);
+
+    // Every frame is printed and the parameter is back at its value afterwards
+    eq = gc_equation_compile(ctx, "y = b*x");
+    CHECK(eq != NULL);
+    if (eq) {
+        eqs[0] = eq;
+        CHECK(gc_animate(ctx, eqs, 1, view, options, "b", -2, 2, 5, 1000, out) > 0);
+        CHECK_NEAR(gc_equation_residual(eq, 2, 0), -2.0, TEST_TOLERANCE);
+
+        char text[256];
+        int frames = 0;
+        rewind(out);
+        while (fgets(text, sizeof(text), out)) frames += strstr(text, " of 5, ") != NULL;
+        CHECK(frames == 5);
+    }
+    gc_equation_free(eq);
+    fclose(out);
+}
+
+// gc_isa names a known variant, and the one GRAPHCALC_ISA asks for when every CPU can
+// run it; make test runs the tests under the default variant as well
+static void test_isa(void) {
+    static const char* const variants[] = {"avx512f", "avx2", "sse4.2", "default"};
+    const char* isa = gc_isa();
+    int known = 0;
+    for (int v = 0; v < 4; v++) known |= strcmp(isa, variants[v]) == 0;
+    CHECK(known);
+    const char* forced = getenv("GRAPHCALC_ISA");
+    if (forced && strcmp(forced, "default") == 0) CHECK(strcmp(isa, "default") == 0);
+}
+
+int main(void) {
+    gc_context* ctx = gc_context_create();
+    if (!ctx) {
+        printf("could not create a context\n");
+        return 1;
+    }
+
+    test_compile(ctx);
+    test_frame(ctx);
+    test_roots(ctx);
+    test_deep_zoom(ctx);
+    test_intersections(ctx);
+    test_export_points(ctx);
+    test_export_images(ctx);
+    test_export_svg(ctx);
+    test_regions(ctx);
+    test_traced_curves(ctx);
+    test_poles(ctx);
+    test_overlays(ctx);
+    test_definitions(ctx);
+    test_animate(ctx);
+    test_isa();
+
+    gc_context_free(ctx);
+    printf("%d of %d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}